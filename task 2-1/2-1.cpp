@@ -1,16 +1,31 @@
 #include <iostream>
+#include <fstream>
 #include <vector>
 #include <string>
-#include <map>
-#include <set>
-#include <queue>
 #include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <cctype>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <climits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 using std::vector;
-using std::set;
-using std::map;
 using std::string;
-using std::queue;
 using std::cin;
 using std::cout;
 using std::endl;
@@ -26,15 +41,248 @@ struct Substring
   int positionInPattern;
 };
 
+const int LETTERS_COUNT = 256;
+const int NOT_IN_ALPHABET = -1;
+
+// Alphabet policies map a letter to its index in the transition tables or
+// to NOT_IN_ALPHABET. Init is given the strings an automaton is built from.
+class LowercaseAlphabet
+{
+public:
+  void Init(const vector<string> &)
+  {
+  }
+  int GetSize() const
+  {
+    return LAST_LETTER - FIRST_LETTER + 1;
+  }
+  int GetIndex(char letter) const
+  {
+    return (FIRST_LETTER <= letter && letter <= LAST_LETTER) ? 
+      letter - FIRST_LETTER : NOT_IN_ALPHABET;
+  }
+};
+
+// Folds 'A'..'Z' to 'a'..'z' and keeps every other byte as it is
+class CaseInsensitiveAlphabet
+{
+public:
+  void Init(const vector<string> &)
+  {
+  }
+  int GetSize() const
+  {
+    return LETTERS_COUNT;
+  }
+  int GetIndex(char letter) const
+  {
+    if ('A' <= letter && letter <= 'Z')
+    {
+      return letter - 'A' + FIRST_LETTER;
+    }
+    return static_cast<unsigned char>(letter);
+  }
+};
+
+class ByteAlphabet
+{
+public:
+  void Init(const vector<string> &)
+  {
+  }
+  int GetSize() const
+  {
+    return LETTERS_COUNT;
+  }
+  int GetIndex(char letter) const
+  {
+    return static_cast<unsigned char>(letter);
+  }
+};
+
+// Numbers only the bytes that occur in the strings, so tables stay as
+// narrow as the patterns allow. All other bytes share index 0, which never
+// starts a trie edge and so always leads back to the initial state.
+class CompressedAlphabet
+{
+private:
+  int indices[LETTERS_COUNT];
+  int size;
+
+public:
+  CompressedAlphabet() : size(1)
+  {
+    std::fill(indices, indices + LETTERS_COUNT, 0);
+  }
+  void Init(const vector<string> & strings)
+  {
+    std::fill(indices, indices + LETTERS_COUNT, 0);
+    size = 1;
+    for (vector<string>::const_iterator it = strings.begin(); it != strings.end(); ++it)
+    {
+      for (string::const_iterator letter = it->begin(); letter != it->end(); ++letter)
+      {
+        int & index = indices[static_cast<unsigned char>(*letter)];
+        if (0 == index)
+        {
+          index = size++;
+        }
+      }
+    }
+  }
+  int GetSize() const
+  {
+    return size;
+  }
+  int GetIndex(char letter) const
+  {
+    return indices[static_cast<unsigned char>(letter)];
+  }
+  void SetIndices(const int * newIndices, int newSize)
+  {
+    std::copy(newIndices, newIndices + LETTERS_COUNT, indices);
+    size = newSize;
+  }
+};
+
+const size_t ARENA_ALIGNMENT = 16;
+const size_t ARENA_MIN_BLOCK_SIZE = 1 << 12;
+
+// Bump allocator owning a chain of memory blocks that are all released at
+// once. Only trivially destructible objects may be created in it.
+class Arena
+{
+private:
+  struct Block
+  {
+    Block * previous;
+    size_t size;
+  };
+
+  Block * lastBlock;
+  char * position;
+  char * end;
+  int blocksCount;
+
+  Arena(const Arena &);
+  Arena & operator=(const Arena &);
+
+  static size_t AlignUp(size_t size)
+  {
+    return (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+  }
+
+  void AddBlock(size_t size)
+  {
+    size_t headerSize = AlignUp(sizeof(Block));
+    Block * block = static_cast<Block *>(malloc(headerSize + size));
+    if (NULL == block)
+    {
+      throw std::bad_alloc();
+    }
+    block->previous = lastBlock;
+    block->size = size;
+    lastBlock = block;
+    ++blocksCount;
+    position = reinterpret_cast<char *>(block) + headerSize;
+    end = position + size;
+  }
+
+public:
+  Arena() : lastBlock(NULL), position(NULL), end(NULL), blocksCount(0)
+  {
+  }
+
+  ~Arena()
+  {
+    Release();
+  }
+
+  // Makes sure that the next bytesCount bytes are served by one block
+  void Reserve(size_t bytesCount)
+  {
+    if (static_cast<size_t>(end - position) < bytesCount)
+    {
+      AddBlock(std::max(AlignUp(bytesCount), ARENA_MIN_BLOCK_SIZE));
+    }
+  }
+
+  void * Allocate(size_t bytesCount)
+  {
+    bytesCount = AlignUp(bytesCount);
+    if (static_cast<size_t>(end - position) < bytesCount)
+    {
+      size_t blockSize = (NULL == lastBlock) ? ARENA_MIN_BLOCK_SIZE : 2 * lastBlock->size;
+      AddBlock(std::max(blockSize, bytesCount));
+    }
+    void * result = position;
+    position += bytesCount;
+    return result;
+  }
+
+  template <class T>
+  T * Create()
+  {
+    return new (Allocate(sizeof(T))) T();
+  }
+
+  void Release()
+  {
+    while (NULL != lastBlock)
+    {
+      Block * previous = lastBlock->previous;
+      free(lastBlock);
+      lastBlock = previous;
+    }
+    position = NULL;
+    end = NULL;
+    blocksCount = 0;
+  }
+
+  // Every block is one call to malloc
+  int GetBlocksCount() const
+  {
+    return blocksCount;
+  }
+};
+
+struct LabelEntry
+{
+  int label;
+  const LabelEntry * next;
+};
+
+// Children form a singly linked list and labels are a list that ends with
+// the labels of the suffix link, so a node never allocates on its own.
+// Letters are indices in the alphabet of the trie.
 template <class AuxiliaryData>
 class TrieNode 
 {
-  set<int> labels;
-  map<char, TrieNode<AuxiliaryData> > edges;
+  int letter;
+  TrieNode<AuxiliaryData> * firstChild;
+  TrieNode<AuxiliaryData> * nextSibling;
+  // The last of the own labels, where the labels of the suffix link are linked
+  LabelEntry * lastOwnLabel;
+  const LabelEntry * labels;
   AuxiliaryData auxiliaryData;
 
+  TrieNode<AuxiliaryData> * FindChild(int letter) const
+  {
+    for (TrieNode<AuxiliaryData> * child = firstChild; NULL != child; child = child->nextSibling)
+    {
+      if (child->letter == letter)
+      {
+        return child;
+      }
+    }
+    return NULL;
+  }
+
 public:
-  explicit TrieNode() {}
+  explicit TrieNode() : 
+  letter(0), firstChild(NULL), nextSibling(NULL), lastOwnLabel(NULL), labels(NULL) 
+  {
+  }
 
   const AuxiliaryData & GetAuxiliaryData() const
   {
@@ -46,77 +294,109 @@ public:
       return this->auxiliaryData;
   }
 
-  TrieNode<AuxiliaryData> & GetNodeByLetter(char letter)
+  TrieNode<AuxiliaryData> & GetNodeByLetter(int letter)
   {
-    if (edges.end() != edges.find(letter))
+    TrieNode<AuxiliaryData> * child = FindChild(letter);
+    if (NULL != child)
     {
-      return edges.find(letter)->second;
+      return *child;
     }
-    string errorMessage = "wrong letter ";
-    errorMessage += letter;
-    throw invalid_argument(errorMessage);
+    throw invalid_argument("wrong letter index");
   }
 
-  void SetNodeForLetter(char letter, const TrieNode<AuxiliaryData> & node)
-  {
-    edges[letter] = node;
-  }
-
-  const set<int>& GetLabels() const
+  const LabelEntry * GetLabels() const
   {
     return labels;
   }
 
-  void AddLabel(int label) 
+  void AddLabel(int label, Arena & arena) 
   {
-    labels.insert(label);
+    LabelEntry * labelEntry = arena.Create<LabelEntry>();
+    labelEntry->label = label;
+    labelEntry->next = labels;
+    if (NULL == lastOwnLabel)
+    {
+      lastOwnLabel = labelEntry;
+    }
+    labels = labelEntry;
   }
 
-  void AddLabels(const set<int> & labels) 
+  // Appends the labels of another node, usually the suffix link, after the
+  // own labels; the other list is shared, not copied
+  void AddLabels(const LabelEntry * otherLabels) 
   {
-    this->labels.insert(labels.begin(), labels.end());
+    if (NULL == lastOwnLabel)
+    {
+      labels = otherLabels;
+      return;
+    }
+    lastOwnLabel->next = otherLabels;
   }
 
-  bool HasEdge(char letter) const
+  bool HasEdge(int letter) const
   {
-    return edges.count(letter) > 0;
+    return NULL != FindChild(letter);
   }
 
-  const TrieNode<AuxiliaryData>& GetChildNode(char letter) const
+  const TrieNode<AuxiliaryData>& GetChildNode(int letter) const
   {
-    return edges.find(letter)->second;
+    return *FindChild(letter);
   }
 
-  TrieNode<AuxiliaryData>& GetChildNode(char letter)
+  TrieNode<AuxiliaryData>& GetChildNode(int letter, Arena & arena)
   {
-    return edges[letter];
+    TrieNode<AuxiliaryData> * child = FindChild(letter);
+    if (NULL == child)
+    {
+      child = arena.Create< TrieNode<AuxiliaryData> >();
+      child->letter = letter;
+      child->nextSibling = firstChild;
+      firstChild = child;
+    }
+    return *child;
   }
 };
 
 
-template <class AuxiliaryData>
+template <class AuxiliaryData, class Alphabet>
 class Trie 
 {
 private:
+  Alphabet alphabet;
+  Arena arena;
   TrieNode<AuxiliaryData>* root;
   vector<int> patternLengths;
+  int nodesCount;
 
   void AddSubstring(TrieNode<AuxiliaryData>& node,
     const string & string, 
-    int startPosition, 
+    size_t startPosition, 
     int label) 
   {
-    if (string.size() > startPosition) 
-    {
-      char letter = string[startPosition];
-      AddSubstring(node.GetChildNode(letter), string, startPosition + 1, label);
-    } 
-    else 
+    TrieNode<AuxiliaryData> * currentNode = &node;
+    for (size_t position = startPosition; position < string.size(); ++position)
     {
-      node.AddLabel(label);
+      int letter = alphabet.GetIndex(string[position]);
+      if (NOT_IN_ALPHABET == letter)
+      {
+        std::string errorMessage = "wrong letter ";
+        errorMessage += string[position];
+        throw invalid_argument(errorMessage);
+      }
+      if (!currentNode->HasEdge(letter))
+      {
+        ++nodesCount;
+      }
+      currentNode = &currentNode->GetChildNode(letter, arena);
     }
+    currentNode->AddLabel(label, arena);
   }
+
 public:
+  Trie() : root(NULL), nodesCount(0)
+  {
+  }
+
   TrieNode<AuxiliaryData>* GetRoot()
   {
     return this->root;
@@ -127,11 +407,31 @@ public:
     return this->root;
   }
 
-  TrieNode<AuxiliaryData>* GetNextNode(TrieNode<AuxiliaryData>* node, const char letter) const 
+  const Alphabet & GetAlphabet() const
+  {
+    return alphabet;
+  }
+
+  int GetNodesCount() const
+  {
+    return nodesCount;
+  }
+
+  int GetArenaBlocksCount() const
+  {
+    return arena.GetBlocksCount();
+  }
+
+  const vector<int> & GetPatternLengths() const
+  {
+    return patternLengths;
+  }
+
+  TrieNode<AuxiliaryData>* GetNextNode(TrieNode<AuxiliaryData>* node, const int letter) const 
   {
     if (node->HasEdge(letter)) 
     {
-      return &node->GetChildNode(letter);
+      return &node->GetNodeByLetter(letter);
     } 
     else
     { 
@@ -146,20 +446,30 @@ public:
     patternLengths.push_back(str.length());
   }
 
+  // All nodes and labels go to one arena block sized for the worst case
   void Init(const vector<string> & strings) 
   {
-    root = new TrieNode<AuxiliaryData>();    
+    size_t lettersCount = 0;
+    for (vector<string>::const_iterator it = strings.begin(); 
+      it < strings.end(); ++it) 
+    {
+      lettersCount += it->size();
+    }
+    alphabet.Init(strings);
+    arena.Release();
+    arena.Reserve((lettersCount + 1) * 
+      ((sizeof(TrieNode<AuxiliaryData>) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1)) +
+      strings.size() * ((sizeof(LabelEntry) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1)));
+    root = arena.Create< TrieNode<AuxiliaryData> >();
+    nodesCount = 1;
+    patternLengths.clear();
+    patternLengths.reserve(strings.size());
     for (vector<string>::const_iterator it = strings.begin(); 
       it < strings.end(); ++it) 
     {
       AddString(*it);
     }
   }
-
-  ~Trie() 
-  {
-    delete(root);
-  }
 };
 
 class AhoCorasickNodesData {
@@ -171,7 +481,7 @@ public:
   {
     return this->suffixLink;
   }
-  AhoCorasickNodesData() {}
+  AhoCorasickNodesData() : suffixLink(NULL), terminalLink(NULL) {}
   AhoCorasickNodesData(TrieNode<AhoCorasickNodesData> * suffixLink,
       TrieNode<AhoCorasickNodesData> * terminalLink) :
   suffixLink(suffixLink), terminalLink(terminalLink)
@@ -181,24 +491,28 @@ public:
 
 typedef TrieNode<AhoCorasickNodesData> AutomatNode;
 
+// Owns its trie, and with it every node and label, so nothing outlives
+// the automaton
+template <class Alphabet = LowercaseAlphabet>
 class Automat
 {
 private:
-  Trie<AhoCorasickNodesData> * root;
-  AutomatNode* initialState;
+  Trie<AhoCorasickNodesData, Alphabet> trie;
   AutomatNode * currentState;
-  vector<int> patternLengths;
+
+  Automat(const Automat &);
+  Automat & operator=(const Automat &);
 
 public:TrieNode<AhoCorasickNodesData>* 
-           GetNextNode(TrieNode<AhoCorasickNodesData>* node, const char letter) const 
+           GetNextNode(TrieNode<AhoCorasickNodesData>* node, const int letter) const 
   {
     if (node->HasEdge(letter)) 
     {
-      return &node->GetChildNode(letter);
+      return &node->GetNodeByLetter(letter);
     } 
-    else if (node == this->root->GetRoot()) 
+    else if (node == this->trie.GetRoot()) 
     { 
-      return this->root->GetRoot();
+      return const_cast<AutomatNode *>(this->trie.GetRoot());
     } 
     else 
     {
@@ -206,67 +520,41 @@ public:TrieNode<AhoCorasickNodesData>*
     }
   }
 
-  void AddSubstring(TrieNode<AhoCorasickNodesData>& node,
-    const string & string, 
-    int startPosition, 
-    int label) 
-  {
-    if (string.size() > startPosition) 
-    {
-      char letter = string[startPosition];
-      AddSubstring(node.GetChildNode(letter), string, startPosition + 1, label);
-    } 
-    else 
-    {
-      node.AddLabel(label);
-    }
-  }
-
-  void AddString(const string & str) 
-  {
-    int newLabel = patternLengths.size();
-    AddSubstring(*this->root->GetRoot(), str, 0, newLabel);
-    patternLengths.push_back(str.length());
-  }
-
   void BuildSuffixForest() 
   {
-    this->currentState = new AutomatNode();
-    this->currentState = this->root->GetRoot();
-    this->root->GetRoot()->GetAuxiliaryData() = *(new AhoCorasickNodesData(this->root->GetRoot(), 
-      this->root->GetRoot()));
-    queue< TrieNode<AhoCorasickNodesData>* > nodes;
+    AutomatNode * root = this->trie.GetRoot();
+    this->currentState = root;
+    root->GetAuxiliaryData() = AhoCorasickNodesData(root, root);
+    vector<AutomatNode *> nodes;
+    nodes.reserve(this->trie.GetNodesCount());
 
-    for (char letter = FIRST_LETTER; letter <= LAST_LETTER; ++letter)
+    int alphabetSize = this->trie.GetAlphabet().GetSize();
+    for (int letter = 0; letter < alphabetSize; ++letter)
     {
-      if (this->root->GetRoot()->HasEdge(letter))
+      if (root->HasEdge(letter))
       {
-          this->root->GetRoot()->GetNodeByLetter(letter).GetAuxiliaryData() = 
-          (*(new AhoCorasickNodesData(this->root->GetRoot(), 
-          this->root->GetRoot())));
-        nodes.push(&(this->root->GetRoot()->GetNodeByLetter(letter)));
+        root->GetNodeByLetter(letter).GetAuxiliaryData() = AhoCorasickNodesData(root, root);
+        nodes.push_back(&(root->GetNodeByLetter(letter)));
       }
     }
 
-    while (!nodes.empty()) 
+    for (size_t nodeIndex = 0; nodeIndex < nodes.size(); ++nodeIndex) 
     {
-      TrieNode<AhoCorasickNodesData>* frontNode = nodes.front();
-      nodes.pop();
-      for (char letter = FIRST_LETTER; letter < LAST_LETTER; ++letter)
+      TrieNode<AhoCorasickNodesData>* frontNode = nodes[nodeIndex];
+      for (int letter = 0; letter < alphabetSize; ++letter)
       {
         if (true == frontNode->HasEdge(letter))
         {
           TrieNode<AhoCorasickNodesData>* childNode = &(frontNode->GetNodeByLetter(letter));
           TrieNode<AhoCorasickNodesData>* transitionNode = 
             frontNode->GetAuxiliaryData().GetSuffixLink();
-          nodes.push(childNode);
+          nodes.push_back(childNode);
           while (GetNextNode(transitionNode, letter) == NULL) 
           {
             transitionNode = transitionNode->GetAuxiliaryData().GetSuffixLink();
           }
-          childNode->GetAuxiliaryData() = (*(new AhoCorasickNodesData(GetNextNode(transitionNode, 
-            letter), 
-            this->root->GetRoot())));
+          childNode->GetAuxiliaryData() = AhoCorasickNodesData(GetNextNode(transitionNode, letter), 
+            root);
           childNode->AddLabels(childNode->GetAuxiliaryData().GetSuffixLink()->GetLabels());
         }
       }
@@ -274,23 +562,29 @@ public:TrieNode<AhoCorasickNodesData>*
   }
 
 public:
-  void Init(const vector<string> & strings)
+  Automat() : currentState(NULL)
   {
-    this->initialState = new AutomatNode;
-    this->root = new Trie<AhoCorasickNodesData>();  
-    this->root->Init(strings);
-    this->initialState = this->root->GetRoot();
-    for (vector<string>::const_iterator it = strings.begin(); 
-      it != strings.end(); ++it) 
-    {
-      AddString(*it);
-    }
+  }
 
+  void Init(const vector<string> & strings)
+  {
+    this->trie.Init(strings);
     BuildSuffixForest();
   }
 
-  void MakeTransitionAuto(char letter)
+  int GetArenaBlocksCount() const
+  {
+    return this->trie.GetArenaBlocksCount();
+  }
+
+  void MakeTransitionAuto(char textLetter)
   {
+    int letter = this->trie.GetAlphabet().GetIndex(textLetter);
+    if (NOT_IN_ALPHABET == letter)
+    {
+      this->currentState = this->trie.GetRoot();
+      return;
+    }
     while (GetNextNode(this->currentState, letter) == NULL) 
     {
       this->currentState = 
@@ -299,100 +593,1940 @@ public:
     this->currentState = GetNextNode(this->currentState, letter);
   }
 
-  vector< vector<int> > FindSubstringsPositionsAuto(const string & text)
+  vector< vector<long long> > FindSubstringsPositionsAuto(const string & text)
   {
-    vector< vector<int> > patternPartsPositions;
-    for (int counter = 0; counter < patternLengths.size(); ++counter)
-    {
-      patternPartsPositions.push_back(vector<int>());
-    }
-    for (int letterPosition = 0; letterPosition < text.size(); ++letterPosition)
+    const vector<int> & patternLengths = this->trie.GetPatternLengths();
+    vector< vector<long long> > patternPartsPositions(patternLengths.size());
+    for (size_t letterPosition = 0; letterPosition < text.size(); ++letterPosition)
     {
       char letter = text[letterPosition];
       MakeTransitionAuto(letter);
-      for (set<int>::const_iterator it = currentState->GetLabels().begin();
-        it != currentState->GetLabels().end(); ++it) 
+      for (const LabelEntry * it = currentState->GetLabels(); NULL != it; it = it->next) 
       {
-        patternPartsPositions[*it].push_back(letterPosition - patternLengths[*it] + 1);
+        patternPartsPositions[it->label].push_back(
+          static_cast<long long>(letterPosition) - patternLengths[it->label] + 1);
       }
     }
     return patternPartsPositions;
   }
 };
 
-void Split(const std::string& string, vector<Substring> & substrings, char delimiter)
+const int INITIAL_STATE = 0;
+const int NO_TRANSITION = -1;
+
+// Read-only view of an array owned elsewhere: by a vector or by a mapped file
+template <class T>
+class ArrayRef
 {
-  string::size_type previousPosition = string.find_first_not_of(delimiter, 0);
-  string::size_type nextPosition = string.find_first_of(delimiter, previousPosition);
-  while (string::npos != nextPosition || string::npos != previousPosition) 
+private:
+  const T * elements;
+  size_t elementsCount;
+
+public:
+  ArrayRef() : elements(NULL), elementsCount(0)
   {
-    Substring substring;
-    substring.patternPart = string.substr(previousPosition, nextPosition - previousPosition);
-    substring.positionInPattern = previousPosition;
-    substrings.push_back(substring);
-    previousPosition = string.find_first_not_of(delimiter, nextPosition);
-    nextPosition = string.find_first_of(delimiter, previousPosition);
+  }
+
+  explicit ArrayRef(const vector<T> & storage) : 
+  elements(storage.empty() ? NULL : &storage[0]), elementsCount(storage.size())
+  {
+  }
+
+  ArrayRef(const T * elements, size_t elementsCount) :
+  elements(elements), elementsCount(elementsCount)
+  {
+  }
+
+  const T & operator[](size_t index) const
+  {
+    return elements[index];
+  }
+
+  size_t size() const
+  {
+    return elementsCount;
+  }
+
+  const T * begin() const
+  {
+    return elements;
+  }
+
+  const T * end() const
+  {
+    return elements + elementsCount;
+  }
+};
+
+template <class T>
+void WriteArray(FILE * file, const ArrayRef<T> & array)
+{
+  if (array.size() > 0)
+  {
+    fwrite(array.begin(), sizeof(T), array.size(), file);
   }
 }
 
-vector<int> FindOccurences(const string& text, const string& pattern) 
+// Takes elementsCount elements of T at position in place and moves past them
+template <class T>
+bool ReadArray(const char *& position, const char * end, size_t elementsCount, ArrayRef<T> & array)
 {
-  vector<Substring> substrings;
-  Split(pattern, substrings, WILDCARD);
-  vector<string> patternParts;
-  for (vector<Substring>::iterator substringIter = substrings.begin();
-    substringIter != substrings.end(); ++substringIter)
+  if (static_cast<size_t>(end - position) / sizeof(T) < elementsCount)
   {
-    patternParts.push_back(substringIter->patternPart);
+    return false;
   }
-  Automat automat = Automat();
-  automat.Init(patternParts);
-  vector<int> positionsTableForAllPatterns(text.length());
-  vector< vector<int> > patternPartsPositions = automat.FindSubstringsPositionsAuto(text);
-  for (int patternPart = 0; patternPart < patternPartsPositions.size(); ++patternPart) 
+  array = ArrayRef<T>(reinterpret_cast<const T *>(position), elementsCount);
+  position += elementsCount * sizeof(T);
+  return true;
+}
+
+// A fixed alphabet can only load tables that were built with it
+template <class Alphabet>
+bool LoadAlphabet(Alphabet & alphabet, const int * indices, int size)
+{
+  if (alphabet.GetSize() != size)
   {
-    int delta = substrings[patternPart].positionInPattern;
-    const vector<int>& patternPositions = patternPartsPositions[patternPart];
-    for (vector<int>::const_iterator letterPosition = patternPositions.begin();
-      letterPosition < patternPositions.end(); ++letterPosition) 
-    {
-      if (*letterPosition - delta < 0) 
-      {
-        continue;
-      }
-      positionsTableForAllPatterns[*letterPosition - delta]++;
-    }
+    return false;
   }
-  vector<int> positions;
-  for (int i = 0; i < positionsTableForAllPatterns.size(); ++i) 
+  for (int letter = 0; letter < LETTERS_COUNT; ++letter)
   {
-    if (positionsTableForAllPatterns[i] == substrings.size() && 
-      i + pattern.size() <= text.size()) 
+    if (alphabet.GetIndex(static_cast<char>(letter)) != indices[letter])
     {
-      positions.push_back(i);
+      return false;
     }
   }
-  return positions;
+  return true;
 }
 
-template<typename T>
-void PrintVector(vector<T> vectorToPrint)
+bool LoadAlphabet(CompressedAlphabet & alphabet, const int * indices, int size)
 {
-  cout << vectorToPrint.size() << endl;
-  for (int counter = 0; counter < vectorToPrint.size(); ++counter)
+  for (int letter = 0; letter < LETTERS_COUNT; ++letter)
   {
-    cout << vectorToPrint[counter] << " ";
+    if (indices[letter] < 0 || indices[letter] >= size)
+    {
+      return false;
+    }
   }
-  cout << endl;
+  alphabet.SetIndices(indices, size);
+  return true;
 }
 
-int main() 
+// Aho-Corasick automaton kept in contiguous arrays: a dense goto table with
+// precomputed failure transitions and own labels stored as CSR ranges. Output
+// links chain the states whose labels are matched too, so the labels of a
+// suffix are never copied.
+template <class Alphabet>
+class BasicFlatAutomat
 {
-  string pattern;
-  cin >> pattern;
-  string text;
-  cin >> text;
-  vector<int> occurrences = FindOccurences(text, pattern);
-  PrintVector(occurrences);
+private:
+  Alphabet alphabet;
+  int alphabetSize;
+  vector<int> transitionsStorage;
+  vector<int> labelOffsetsStorage;
+  vector<int> labelsStorage;
+  vector<int> outputLinksStorage;
+  vector<int> patternLengthsStorage;
+  int statesCount;
+  ArrayRef<int> transitions; // transitions[state * alphabetSize + letter]
+  ArrayRef<int> labelOffsets; // own labels of state are [labelOffsets[state], labelOffsets[state + 1])
+  ArrayRef<int> labels;
+  ArrayRef<int> outputLinks; // nearest proper suffix state with own labels, or the initial state
+  ArrayRef<int> patternLengths;
+
+  BasicFlatAutomat(const BasicFlatAutomat &);
+  BasicFlatAutomat & operator=(const BasicFlatAutomat &);
+
+  int AddString(const string & str)
+  {
+    int state = INITIAL_STATE;
+    for (size_t position = 0; position < str.size(); ++position)
+    {
+      int letter = alphabet.GetIndex(str[position]);
+      if (NOT_IN_ALPHABET == letter)
+      {
+        string errorMessage = "wrong letter ";
+        errorMessage += str[position];
+        throw invalid_argument(errorMessage);
+      }
+      if (NO_TRANSITION == transitionsStorage[state * alphabetSize + letter])
+      {
+        transitionsStorage[state * alphabetSize + letter] = transitionsStorage.size() / alphabetSize;
+        transitionsStorage.resize(transitionsStorage.size() + alphabetSize, NO_TRANSITION);
+      }
+      state = transitionsStorage[state * alphabetSize + letter];
+    }
+    return state;
+  }
+
+  // Output links lead to shorter suffixes, so every chain of them must reach
+  // the initial state. Walks each chain once, marking the states on it.
+  bool OutputLinksReachInitialState() const
+  {
+    const char UNKNOWN = 0;
+    const char ON_CHAIN = 1;
+    const char REACHES_INITIAL = 2;
+    vector<char> statuses(statesCount, UNKNOWN);
+    statuses[INITIAL_STATE] = REACHES_INITIAL;
+    vector<int> chain;
+    for (int state = 0; state < statesCount; ++state)
+    {
+      int chainState = state;
+      while (UNKNOWN == statuses[chainState])
+      {
+        statuses[chainState] = ON_CHAIN;
+        chain.push_back(chainState);
+        chainState = outputLinks[chainState];
+      }
+      if (ON_CHAIN == statuses[chainState])
+      {
+        return false;
+      }
+      for (size_t counter = 0; counter < chain.size(); ++counter)
+      {
+        statuses[chain[counter]] = REACHES_INITIAL;
+      }
+      chain.clear();
+    }
+    return true;
+  }
+
+  // Tables read from a file are trusted no further than their sizes, so
+  // every index in them is checked against the table it points into
+  bool TablesAreConsistent() const
+  {
+    for (size_t counter = 0; counter < transitions.size(); ++counter)
+    {
+      if (transitions[counter] < 0 || transitions[counter] >= statesCount)
+      {
+        return false;
+      }
+    }
+    if (0 != labelOffsets[0] || 
+      static_cast<size_t>(labelOffsets[statesCount]) != labels.size())
+    {
+      return false;
+    }
+    for (int state = 0; state < statesCount; ++state)
+    {
+      if (labelOffsets[state] > labelOffsets[state + 1] || 
+        outputLinks[state] < 0 || outputLinks[state] >= statesCount)
+      {
+        return false;
+      }
+    }
+    for (size_t counter = 0; counter < labels.size(); ++counter)
+    {
+      if (labels[counter] < 0 || static_cast<size_t>(labels[counter]) >= patternLengths.size())
+      {
+        return false;
+      }
+    }
+    for (size_t counter = 0; counter < patternLengths.size(); ++counter)
+    {
+      if (patternLengths[counter] < 0)
+      {
+        return false;
+      }
+    }
+    return OutputLinksReachInitialState();
+  }
+
+public:
+  BasicFlatAutomat() : alphabetSize(0), statesCount(0)
+  {
+  }
+
+  void Init(const vector<string> & strings)
+  {
+    size_t maxStatesCount = 1;
+    for (size_t counter = 0; counter < strings.size(); ++counter)
+    {
+      maxStatesCount += strings[counter].size();
+    }
+    alphabet.Init(strings);
+    alphabetSize = alphabet.GetSize();
+    transitionsStorage.clear();
+    transitionsStorage.reserve(maxStatesCount * alphabetSize);
+    transitionsStorage.resize(alphabetSize, NO_TRANSITION);
+    patternLengthsStorage.clear();
+    vector<int> terminalStates;
+    for (size_t counter = 0; counter < strings.size(); ++counter)
+    {
+      terminalStates.push_back(AddString(strings[counter]));
+      patternLengthsStorage.push_back(strings[counter].size());
+    }
+    statesCount = transitionsStorage.size() / alphabetSize;
+
+    // Own labels of every state, grouped by state with a counting pass
+    labelOffsetsStorage.assign(statesCount + 1, 0);
+    for (size_t label = 0; label < terminalStates.size(); ++label)
+    {
+      ++labelOffsetsStorage[terminalStates[label] + 1];
+    }
+    for (int state = 0; state < statesCount; ++state)
+    {
+      labelOffsetsStorage[state + 1] += labelOffsetsStorage[state];
+    }
+    labelsStorage.resize(terminalStates.size());
+    vector<int> labelsFilled(labelOffsetsStorage.begin(), labelOffsetsStorage.end() - 1);
+    for (size_t label = 0; label < terminalStates.size(); ++label)
+    {
+      labelsStorage[labelsFilled[terminalStates[label]]++] = label;
+    }
+
+    // Breadth-first pass: suffix links, failure transitions and output links
+    vector<int> suffixLinks(statesCount, INITIAL_STATE);
+    outputLinksStorage.assign(statesCount, INITIAL_STATE);
+    vector<int> statesOrder;
+    statesOrder.reserve(statesCount);
+    statesOrder.push_back(INITIAL_STATE);
+    for (size_t orderIndex = 0; orderIndex < statesOrder.size(); ++orderIndex)
+    {
+      int state = statesOrder[orderIndex];
+      int suffixLink = suffixLinks[state];
+      if (INITIAL_STATE != state)
+      {
+        outputLinksStorage[state] = 
+          (labelOffsetsStorage[suffixLink] != labelOffsetsStorage[suffixLink + 1]) ?
+          suffixLink : outputLinksStorage[suffixLink];
+      }
+      for (int letter = 0; letter < alphabetSize; ++letter)
+      {
+        int & nextState = transitionsStorage[state * alphabetSize + letter];
+        if (NO_TRANSITION == nextState)
+        {
+          nextState = (INITIAL_STATE == state) ? 
+            INITIAL_STATE : transitionsStorage[suffixLink * alphabetSize + letter];
+        }
+        else
+        {
+          suffixLinks[nextState] = (INITIAL_STATE == state) ? 
+            INITIAL_STATE : transitionsStorage[suffixLink * alphabetSize + letter];
+          statesOrder.push_back(nextState);
+        }
+      }
+    }
+
+    transitions = ArrayRef<int>(transitionsStorage);
+    labelOffsets = ArrayRef<int>(labelOffsetsStorage);
+    labels = ArrayRef<int>(labelsStorage);
+    outputLinks = ArrayRef<int>(outputLinksStorage);
+    patternLengths = ArrayRef<int>(patternLengthsStorage);
+  }
+
+  void Save(FILE * file) const
+  {
+    int header[] = { alphabetSize, statesCount, static_cast<int>(labels.size()), 
+      static_cast<int>(patternLengths.size()) };
+    fwrite(header, sizeof(header), 1, file);
+    int indices[LETTERS_COUNT];
+    for (int letter = 0; letter < LETTERS_COUNT; ++letter)
+    {
+      indices[letter] = alphabet.GetIndex(static_cast<char>(letter));
+    }
+    fwrite(indices, sizeof(indices), 1, file);
+    WriteArray(file, transitions);
+    WriteArray(file, labelOffsets);
+    WriteArray(file, labels);
+    WriteArray(file, outputLinks);
+    WriteArray(file, patternLengths);
+  }
+
+  // Points the automaton at arrays written by Save, without copying them;
+  // the data must outlive the automaton. State * alphabetSize + letter has
+  // to fit in an int, which also bounds the size of every table.
+  bool Load(const char *& position, const char * end)
+  {
+    ArrayRef<int> header;
+    ArrayRef<int> indices;
+    if (!ReadArray(position, end, 4, header) || 
+      header[0] < 1 || header[0] > LETTERS_COUNT || header[1] < 1 || 
+      header[1] > INT_MAX / header[0] || header[2] < 0 || header[3] < 0 ||
+      !ReadArray(position, end, LETTERS_COUNT, indices) || 
+      !LoadAlphabet(alphabet, indices.begin(), header[0]))
+    {
+      return false;
+    }
+    alphabetSize = header[0];
+    statesCount = header[1];
+    size_t statesCountSize = static_cast<size_t>(statesCount);
+    return ReadArray(position, end, statesCountSize * alphabetSize, transitions) &&
+      ReadArray(position, end, statesCountSize + 1, labelOffsets) &&
+      ReadArray(position, end, static_cast<size_t>(header[2]), labels) &&
+      ReadArray(position, end, statesCountSize, outputLinks) &&
+      ReadArray(position, end, static_cast<size_t>(header[3]), patternLengths) &&
+      TablesAreConsistent();
+  }
+
+  int MakeTransition(int state, char textLetter) const
+  {
+    int letter = alphabet.GetIndex(textLetter);
+    if (NOT_IN_ALPHABET == letter)
+    {
+      return INITIAL_STATE;
+    }
+    return transitions[state * alphabetSize + letter];
+  }
+
+  // Labels matched in a state are the own labels of the state and of every
+  // state on its chain of output links
+  const int * GetLabelsBegin(int state) const
+  {
+    return labels.begin() + labelOffsets[state];
+  }
+
+  const int * GetLabelsEnd(int state) const
+  {
+    return labels.begin() + labelOffsets[state + 1];
+  }
+
+  int GetOutputLink(int state) const
+  {
+    return outputLinks[state];
+  }
+
+  int GetPatternLength(int label) const
+  {
+    return patternLengths[label];
+  }
+
+  int GetPatternsCount() const
+  {
+    return patternLengths.size();
+  }
+
+  vector< vector<long long> > FindSubstringsPositionsAuto(const string & text) const
+  {
+    vector< vector<long long> > patternPartsPositions(patternLengths.size());
+    int state = INITIAL_STATE;
+    for (size_t letterPosition = 0; letterPosition < text.size(); ++letterPosition)
+    {
+      state = MakeTransition(state, text[letterPosition]);
+      for (int outputState = state; INITIAL_STATE != outputState; 
+        outputState = outputLinks[outputState])
+      {
+        for (int labelIndex = labelOffsets[outputState]; 
+          labelIndex < labelOffsets[outputState + 1]; ++labelIndex)
+        {
+          int label = labels[labelIndex];
+          patternPartsPositions[label].push_back(
+            static_cast<long long>(letterPosition) - patternLengths[label] + 1);
+        }
+      }
+    }
+    return patternPartsPositions;
+  }
+};
+
+typedef BasicFlatAutomat<CompressedAlphabet> FlatAutomat;
+
+void Split(const std::string& string, vector<Substring> & substrings, char delimiter)
+{
+  string::size_type previousPosition = string.find_first_not_of(delimiter, 0);
+  string::size_type nextPosition = string.find_first_of(delimiter, previousPosition);
+  while (string::npos != nextPosition || string::npos != previousPosition) 
+  {
+    Substring substring;
+    substring.patternPart = string.substr(previousPosition, nextPosition - previousPosition);
+    substring.positionInPattern = previousPosition;
+    substrings.push_back(substring);
+    previousPosition = string.find_first_not_of(delimiter, nextPosition);
+    nextPosition = string.find_first_of(delimiter, previousPosition);
+  }
+}
+
+vector<string> GetPatternParts(const vector<Substring> & substrings)
+{
+  vector<string> patternParts;
+  for (vector<Substring>::const_iterator substringIter = substrings.begin();
+    substringIter != substrings.end(); ++substringIter)
+  {
+    patternParts.push_back(substringIter->patternPart);
+  }
+  return patternParts;
+}
+
+template <class PatternAutomat>
+vector<long long> FindOccurences(const string& text, const string& pattern) 
+{
+  vector<Substring> substrings;
+  Split(pattern, substrings, WILDCARD);
+  PatternAutomat automat;
+  automat.Init(GetPatternParts(substrings));
+  vector<int> positionsTableForAllPatterns(text.length());
+  vector< vector<long long> > patternPartsPositions = automat.FindSubstringsPositionsAuto(text);
+  for (size_t patternPart = 0; patternPart < patternPartsPositions.size(); ++patternPart) 
+  {
+    int delta = substrings[patternPart].positionInPattern;
+    const vector<long long>& patternPositions = patternPartsPositions[patternPart];
+    for (vector<long long>::const_iterator letterPosition = patternPositions.begin();
+      letterPosition < patternPositions.end(); ++letterPosition) 
+    {
+      if (*letterPosition - delta < 0) 
+      {
+        continue;
+      }
+      positionsTableForAllPatterns[*letterPosition - delta]++;
+    }
+  }
+  vector<long long> positions;
+  for (size_t i = 0; i < positionsTableForAllPatterns.size(); ++i) 
+  {
+    if (positionsTableForAllPatterns[i] == static_cast<int>(substrings.size()) && 
+      i + pattern.size() <= text.size()) 
+    {
+      positions.push_back(i);
+    }
+  }
+  return positions;
+}
+
+// Matches a wildcard pattern letter by letter. Hit counters are kept only for
+// the last |pattern| start positions in a ring buffer, and a start position is
+// reported as soon as the letter closing its window has been read.
+template <class PatternAutomat>
+class StreamingMatcher
+{
+private:
+  const PatternAutomat & automat;
+  vector<int> partLastLetterOffsets;
+  vector<int> counters;
+  int partsCount;
+  int state;
+  int currentSlot;
+  long long position;
+
+public:
+  StreamingMatcher(const PatternAutomat & automat, 
+    const vector<Substring> & substrings, 
+    int patternLength) :
+  automat(automat), counters(patternLength, 0), partsCount(substrings.size()), 
+    state(INITIAL_STATE), currentSlot(0), position(0)
+  {
+    for (size_t counter = 0; counter < substrings.size(); ++counter)
+    {
+      partLastLetterOffsets.push_back(substrings[counter].positionInPattern + 
+        substrings[counter].patternPart.size() - 1);
+    }
+  }
+
+  template <class MatchHandler>
+  void ProcessLetter(char letter, MatchHandler & matchHandler)
+  {
+    int windowSize = counters.size();
+    state = automat.MakeTransition(state, letter);
+    for (int outputState = state; INITIAL_STATE != outputState; 
+      outputState = automat.GetOutputLink(outputState))
+    {
+      for (const int * label = automat.GetLabelsBegin(outputState);
+        label != automat.GetLabelsEnd(outputState); ++label)
+      {
+        int offset = partLastLetterOffsets[*label];
+        if (position < offset)
+        {
+          continue;
+        }
+        int slot = currentSlot - offset;
+        if (slot < 0)
+        {
+          slot += windowSize;
+        }
+        ++counters[slot];
+      }
+    }
+    // The oldest start position in the window can not get new hits any more
+    int oldestSlot = (currentSlot + 1 == windowSize) ? 0 : currentSlot + 1;
+    if (position + 1 >= windowSize)
+    {
+      if (counters[oldestSlot] == partsCount)
+      {
+        matchHandler(position + 1 - windowSize);
+      }
+      counters[oldestSlot] = 0;
+    }
+    currentSlot = oldestSlot;
+    ++position;
+  }
+};
+
+const int OUTPUT_BUFFER_SIZE = 1 << 16;
+
+// Formats numbers into a fixed buffer and writes it out in large blocks
+class BufferedWriter
+{
+private:
+  FILE * output;
+  vector<char> buffer;
+  size_t filled;
+
+  BufferedWriter(const BufferedWriter &);
+  BufferedWriter & operator=(const BufferedWriter &);
+
+public:
+  explicit BufferedWriter(FILE * output) :
+  output(output), buffer(OUTPUT_BUFFER_SIZE), filled(0)
+  {
+  }
+
+  ~BufferedWriter()
+  {
+    Flush();
+  }
+
+  void Flush()
+  {
+    if (filled > 0)
+    {
+      fwrite(&buffer[0], 1, filled, output);
+      filled = 0;
+    }
+    fflush(output);
+  }
+
+  void WriteChar(char symbol)
+  {
+    if (filled == buffer.size())
+    {
+      Flush();
+    }
+    buffer[filled++] = symbol;
+  }
+
+  void WriteNumber(long long number)
+  {
+    char digits[24];
+    int digitsCount = 0;
+    unsigned long long absoluteValue = number < 0 ? 
+      0ULL - static_cast<unsigned long long>(number) : number;
+    do
+    {
+      digits[digitsCount++] = '0' + absoluteValue % 10;
+      absoluteValue /= 10;
+    } while (absoluteValue > 0);
+    if (filled + digitsCount + 1 > buffer.size())
+    {
+      Flush();
+    }
+    if (number < 0)
+    {
+      buffer[filled++] = '-';
+    }
+    while (digitsCount > 0)
+    {
+      buffer[filled++] = digits[--digitsCount];
+    }
+  }
+};
+
+class PrintingMatchHandler
+{
+  BufferedWriter & writer;
+  long long matchesCount;
+public:
+  explicit PrintingMatchHandler(BufferedWriter & writer) :
+  writer(writer), matchesCount(0)
+  {
+  }
+  void operator()(long long position)
+  {
+    writer.WriteNumber(position);
+    writer.WriteChar(' ');
+    ++matchesCount;
+  }
+  long long GetMatchesCount() const
+  {
+    return matchesCount;
+  }
+};
+
+const int STREAM_CHUNK_SIZE = 1 << 16;
+
+// Reads the pattern and then the text from input in fixed-size chunks, so
+// memory use depends on the pattern length only
+template <class MatchHandler>
+void FindOccurencesInStream(std::istream & input, 
+  MatchHandler & matchHandler)
+{
+  string pattern;
+  input >> pattern >> std::ws;
+  vector<Substring> substrings;
+  Split(pattern, substrings, WILDCARD);
+  FlatAutomat automat;
+  automat.Init(GetPatternParts(substrings));
+  StreamingMatcher<FlatAutomat> matcher(automat, substrings, pattern.size());
+  vector<char> chunk(STREAM_CHUNK_SIZE);
+  bool textEnded = false;
+  while (!textEnded)
+  {
+    std::streamsize chunkLength = input.rdbuf()->sgetn(&chunk[0], chunk.size());
+    if (chunkLength <= 0)
+    {
+      break;
+    }
+    for (std::streamsize counter = 0; counter < chunkLength; ++counter)
+    {
+      if (isspace(static_cast<unsigned char>(chunk[counter])))
+      {
+        textEnded = true;
+        break;
+      }
+      matcher.ProcessLetter(chunk[counter], matchHandler);
+    }
+  }
+}
+
+class CollectingMatchHandler
+{
+  vector<long long> & positions;
+  long long shift;
+public:
+  CollectingMatchHandler(vector<long long> & positions, long long shift) :
+  positions(positions), shift(shift)
+  {
+  }
+  void operator()(long long position)
+  {
+    positions.push_back(shift + position);
+  }
+};
+
+// Collects matches starting in [chunkBegin, chunkEnd). The scanned text is
+// extended by |pattern| - 1 letters so that matches crossing the chunk end
+// are seen by this chunk only.
+class ChunkMatchingTask
+{
+  const FlatAutomat & automat;
+  const vector<Substring> & substrings;
+  const char * text;
+  int patternLength;
+  ptrdiff_t chunkBegin;
+  ptrdiff_t chunkEnd;
+  vector<long long> & positions;
+public:
+  ChunkMatchingTask(const FlatAutomat & automat, 
+    const vector<Substring> & substrings,
+    const char * text, 
+    int patternLength, 
+    ptrdiff_t chunkBegin, 
+    ptrdiff_t chunkEnd,
+    vector<long long> & positions) :
+  automat(automat), substrings(substrings), text(text), patternLength(patternLength),
+    chunkBegin(chunkBegin), chunkEnd(chunkEnd), positions(positions)
+  {
+  }
+  void operator()() const
+  {
+    StreamingMatcher<FlatAutomat> matcher(automat, substrings, patternLength);
+    CollectingMatchHandler collectingMatchHandler(positions, chunkBegin);
+    ptrdiff_t scanEnd = chunkEnd + patternLength - 1;
+    for (ptrdiff_t letterPosition = chunkBegin; letterPosition < scanEnd; ++letterPosition)
+    {
+      matcher.ProcessLetter(text[letterPosition], collectingMatchHandler);
+    }
+  }
+};
+
+// Splits the start positions between threads; every thread runs its own
+// cursor over the shared automaton, and the per-chunk results are already
+// ordered and disjoint, so merging is a concatenation
+vector<long long> FindOccurencesParallel(const char * textBegin, 
+  const char * textEnd, 
+  const string & pattern, 
+  int threadsCount)
+{
+  vector<long long> positions;
+  ptrdiff_t startPositionsCount = (textEnd - textBegin) - 
+    static_cast<ptrdiff_t>(pattern.size()) + 1;
+  if (startPositionsCount <= 0)
+  {
+    return positions;
+  }
+  if (threadsCount <= 0)
+  {
+    threadsCount = std::max(1U, std::thread::hardware_concurrency());
+  }
+  threadsCount = static_cast<int>(std::min<ptrdiff_t>(threadsCount, startPositionsCount));
+  vector<Substring> substrings;
+  Split(pattern, substrings, WILDCARD);
+  FlatAutomat automat;
+  automat.Init(GetPatternParts(substrings));
+  vector< vector<long long> > chunkPositions(threadsCount);
+  vector<std::thread> threads;
+  for (int chunk = 1; chunk < threadsCount; ++chunk)
+  {
+    threads.push_back(std::thread(ChunkMatchingTask(automat, substrings, textBegin, pattern.size(),
+      startPositionsCount * chunk / threadsCount,
+      startPositionsCount * (chunk + 1) / threadsCount,
+      chunkPositions[chunk])));
+  }
+  ChunkMatchingTask(automat, substrings, textBegin, pattern.size(),
+    0, startPositionsCount / threadsCount, chunkPositions[0])();
+  for (size_t counter = 0; counter < threads.size(); ++counter)
+  {
+    threads[counter].join();
+  }
+  for (int chunk = 0; chunk < threadsCount; ++chunk)
+  {
+    positions.insert(positions.end(), chunkPositions[chunk].begin(), chunkPositions[chunk].end());
+  }
+  return positions;
+}
+
+vector<long long> FindOccurencesParallel(const string & text, const string & pattern, 
+  int threadsCount)
+{
+  return FindOccurencesParallel(text.data(), text.data() + text.size(), pattern, threadsCount);
+}
+
+struct FixedLetter
+{
+  int offset;
+  char letter;
+};
+
+vector<FixedLetter> GetFixedLetters(const string & pattern)
+{
+  vector<FixedLetter> fixedLetters;
+  for (size_t offset = 0; offset < pattern.size(); ++offset)
+  {
+    if (WILDCARD != pattern[offset])
+    {
+      FixedLetter fixedLetter;
+      fixedLetter.offset = offset;
+      fixedLetter.letter = pattern[offset];
+      fixedLetters.push_back(fixedLetter);
+    }
+  }
+  return fixedLetters;
+}
+
+void CompareDirectly(const char * text,
+  const vector<FixedLetter> & fixedLetters,
+  ptrdiff_t startBegin,
+  ptrdiff_t startEnd,
+  vector<long long> & positions)
+{
+  for (ptrdiff_t start = startBegin; start < startEnd; ++start)
+  {
+    size_t counter = 0;
+    while (counter < fixedLetters.size() && 
+      text[start + fixedLetters[counter].offset] == fixedLetters[counter].letter)
+    {
+      ++counter;
+    }
+    if (counter == fixedLetters.size())
+    {
+      positions.push_back(start);
+    }
+  }
+}
+
+void AddBlockMatches(unsigned int matchMask, ptrdiff_t blockStart, vector<long long> & positions)
+{
+  while (0 != matchMask)
+  {
+    positions.push_back(blockStart + __builtin_ctz(matchMask));
+    matchMask &= matchMask - 1;
+  }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// Each fixed letter of the pattern is compared with 32 consecutive start
+// positions at once; '?' positions are simply left out of the mask.
+// Returns the first start position that is left for the caller.
+__attribute__((target("avx2")))
+ptrdiff_t CompareBlocksAvx2(const char * text,
+  ptrdiff_t startPositionsCount,
+  const vector<FixedLetter> & fixedLetters,
+  vector<long long> & positions)
+{
+  const int BLOCK_SIZE = 32;
+  ptrdiff_t blockStart = 0;
+  for (; blockStart + BLOCK_SIZE <= startPositionsCount; blockStart += BLOCK_SIZE)
+  {
+    unsigned int matchMask = 0xFFFFFFFFU;
+    for (size_t counter = 0; counter < fixedLetters.size() && 0 != matchMask; ++counter)
+    {
+      __m256i textVector = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(
+        text + blockStart + fixedLetters[counter].offset));
+      matchMask &= _mm256_movemask_epi8(_mm256_cmpeq_epi8(textVector, 
+        _mm256_set1_epi8(fixedLetters[counter].letter)));
+    }
+    AddBlockMatches(matchMask, blockStart, positions);
+  }
+  return blockStart;
+}
+
+// Same as CompareBlocksAvx2 for 16 start positions; SSE2 already has all
+// the byte comparisons this needs
+ptrdiff_t CompareBlocksSse(const char * text,
+  ptrdiff_t startPositionsCount,
+  const vector<FixedLetter> & fixedLetters,
+  vector<long long> & positions)
+{
+  const int BLOCK_SIZE = 16;
+  ptrdiff_t blockStart = 0;
+  for (; blockStart + BLOCK_SIZE <= startPositionsCount; blockStart += BLOCK_SIZE)
+  {
+    unsigned int matchMask = 0xFFFFU;
+    for (size_t counter = 0; counter < fixedLetters.size() && 0 != matchMask; ++counter)
+    {
+      __m128i textVector = _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+        text + blockStart + fixedLetters[counter].offset));
+      matchMask &= _mm_movemask_epi8(_mm_cmpeq_epi8(textVector, 
+        _mm_set1_epi8(fixedLetters[counter].letter)));
+    }
+    AddBlockMatches(matchMask, blockStart, positions);
+  }
+  return blockStart;
+}
+
+#endif
+
+const int BITS_PER_WORD = 64;
+
+// Shift-And over a pattern of at most WORDS_COUNT * 64 letters: bit j of the
+// state is set while the last j + 1 letters match the pattern prefix, and
+// '?' is set in the masks of all letters
+template <int WORDS_COUNT>
+class ShiftAndMatcher
+{
+private:
+  unsigned long long masks[LETTERS_COUNT][WORDS_COUNT];
+  int patternLength;
+
+public:
+  explicit ShiftAndMatcher(const string & pattern) : patternLength(pattern.size())
+  {
+    for (int letter = 0; letter < LETTERS_COUNT; ++letter)
+    {
+      for (int word = 0; word < WORDS_COUNT; ++word)
+      {
+        masks[letter][word] = 0;
+      }
+    }
+    for (int offset = 0; offset < patternLength; ++offset)
+    {
+      unsigned long long bit = 1ULL << (offset % BITS_PER_WORD);
+      for (int letter = 0; letter < LETTERS_COUNT; ++letter)
+      {
+        if (WILDCARD == pattern[offset] || static_cast<char>(letter) == pattern[offset])
+        {
+          masks[letter][offset / BITS_PER_WORD] |= bit;
+        }
+      }
+    }
+  }
+
+  void FindOccurences(const char * textBegin, 
+    const char * textEnd, 
+    vector<long long> & positions) const
+  {
+    unsigned long long state[WORDS_COUNT] = { 0 };
+    int lastWord = (patternLength - 1) / BITS_PER_WORD;
+    unsigned long long lastBit = 1ULL << ((patternLength - 1) % BITS_PER_WORD);
+    for (const char * letter = textBegin; letter != textEnd; ++letter)
+    {
+      const unsigned long long * mask = masks[static_cast<unsigned char>(*letter)];
+      for (int word = WORDS_COUNT - 1; word > 0; --word)
+      {
+        state[word] = ((state[word] << 1) | (state[word - 1] >> (BITS_PER_WORD - 1))) & mask[word];
+      }
+      state[0] = ((state[0] << 1) | 1ULL) & mask[0];
+      if (0 != (state[lastWord] & lastBit))
+      {
+        positions.push_back(letter - textBegin - patternLength + 1);
+      }
+    }
+  }
+};
+
+const int MAX_SHIFT_AND_PATTERN_LENGTH = 4 * BITS_PER_WORD;
+
+vector<long long> FindOccurencesShiftAnd(const char * textBegin, 
+  const char * textEnd, 
+  const string & pattern)
+{
+  vector<long long> positions;
+  if (pattern.size() <= BITS_PER_WORD)
+  {
+    ShiftAndMatcher<1>(pattern).FindOccurences(textBegin, textEnd, positions);
+  }
+  else if (pattern.size() <= 2 * BITS_PER_WORD)
+  {
+    ShiftAndMatcher<2>(pattern).FindOccurences(textBegin, textEnd, positions);
+  }
+  else
+  {
+    ShiftAndMatcher<4>(pattern).FindOccurences(textBegin, textEnd, positions);
+  }
+  return positions;
+}
+
+enum MatchingEngine
+{
+  AUTOMAT_ENGINE,
+  SHIFT_AND_ENGINE,
+  SSE_ENGINE,
+  AVX2_ENGINE
+};
+
+const int SHORT_PATTERN_LENGTH = 32;
+const int MAX_VECTOR_FIXED_LETTERS = 64;
+
+// Direct comparison stops at the first mismatching letter of a block, so it
+// wins for short patterns and for patterns made mostly of '?'. Other
+// patterns that fit in 256 bits go to Shift-And, whose cost per letter does
+// not depend on how many parts match; only the longest ones are left to the
+// automaton
+MatchingEngine ChooseMatchingEngine(const string & pattern)
+{
+  size_t fixedLettersCount = GetFixedLetters(pattern).size();
+  bool preferVector = pattern.size() <= SHORT_PATTERN_LENGTH ||
+    (2 * fixedLettersCount <= pattern.size() && fixedLettersCount <= MAX_VECTOR_FIXED_LETTERS);
+#if defined(__x86_64__) || defined(__i386__)
+  if (preferVector)
+  {
+    return __builtin_cpu_supports("avx2") ? AVX2_ENGINE : SSE_ENGINE;
+  }
+#endif
+  if (pattern.size() <= MAX_SHIFT_AND_PATTERN_LENGTH)
+  {
+    return SHIFT_AND_ENGINE;
+  }
+  return AUTOMAT_ENGINE;
+}
+
+vector<long long> FindOccurencesVectorized(const char * textBegin, 
+  const char * textEnd, 
+  const string & pattern,
+  MatchingEngine engine)
+{
+  vector<long long> positions;
+  ptrdiff_t startPositionsCount = (textEnd - textBegin) - 
+    static_cast<ptrdiff_t>(pattern.size()) + 1;
+  if (startPositionsCount <= 0)
+  {
+    return positions;
+  }
+  vector<FixedLetter> fixedLetters = GetFixedLetters(pattern);
+  ptrdiff_t comparedStarts = 0;
+#if defined(__x86_64__) || defined(__i386__)
+  if (AVX2_ENGINE == engine)
+  {
+    comparedStarts = CompareBlocksAvx2(textBegin, startPositionsCount, fixedLetters, positions);
+  }
+  else if (SSE_ENGINE == engine)
+  {
+    comparedStarts = CompareBlocksSse(textBegin, startPositionsCount, fixedLetters, positions);
+  }
+#endif
+  CompareDirectly(textBegin, fixedLetters, comparedStarts, startPositionsCount, positions);
+  return positions;
+}
+
+vector<long long> FindOccurencesWithBestEngine(const char * textBegin, 
+  const char * textEnd, 
+  const string & pattern)
+{
+  MatchingEngine engine = ChooseMatchingEngine(pattern);
+  if (AUTOMAT_ENGINE == engine)
+  {
+    return FindOccurencesParallel(textBegin, textEnd, pattern, 1);
+  }
+  if (SHIFT_AND_ENGINE == engine)
+  {
+    return FindOccurencesShiftAnd(textBegin, textEnd, pattern);
+  }
+  return FindOccurencesVectorized(textBegin, textEnd, pattern, engine);
+}
+
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+private:
+  int descriptor;
+  char * data;
+  size_t size;
+
+  MappedFile(const MappedFile &);
+  MappedFile & operator=(const MappedFile &);
+
+public:
+  MappedFile() : descriptor(-1), data(NULL), size(0)
+  {
+  }
+
+  ~MappedFile()
+  {
+    if (NULL != data)
+    {
+      munmap(data, size);
+    }
+    if (descriptor >= 0)
+    {
+      close(descriptor);
+    }
+  }
+
+  bool Open(const char * fileName, int advice = MADV_SEQUENTIAL)
+  {
+    descriptor = open(fileName, O_RDONLY);
+    struct stat fileStat;
+    if (descriptor < 0 || fstat(descriptor, &fileStat) != 0)
+    {
+      return false;
+    }
+    size = fileStat.st_size;
+    if (0 == size)
+    {
+      return true;
+    }
+    void * mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (MAP_FAILED == mapping)
+    {
+      return false;
+    }
+    data = static_cast<char *>(mapping);
+    madvise(data, size, advice);
+    return true;
+  }
+
+  const char * GetBegin() const
+  {
+    return data;
+  }
+
+  const char * GetEnd() const
+  {
+    return data + size;
+  }
+};
+
+struct PatternPartTag
+{
+  int pattern;
+  int lastLetterOffset;
+};
+
+const int COMPILED_BATCH_MAGIC = 0x42574341;
+const int COMPILED_BATCH_VERSION = 2;
+
+// Parts of many wildcard patterns in one automaton. Every label is tagged
+// with its pattern and the offset of its last letter in that pattern, and
+// each pattern counts hits in its own window of |pattern| start positions.
+class WildcardPatternBatch
+{
+private:
+  MappedFile mapping;
+  FlatAutomat automat;
+  vector<PatternPartTag> partTagsStorage;
+  vector<int> patternLengthsStorage;
+  vector<int> partsCountsStorage;
+  vector<int> windowOffsetsStorage;
+  ArrayRef<PatternPartTag> partTags;
+  ArrayRef<int> patternLengths;
+  ArrayRef<int> partsCounts;
+  ArrayRef<int> windowOffsets;
+
+  WildcardPatternBatch(const WildcardPatternBatch &);
+  WildcardPatternBatch & operator=(const WildcardPatternBatch &);
+
+public:
+  WildcardPatternBatch()
+  {
+  }
+
+  void Init(const vector<string> & patterns)
+  {
+    vector<string> allParts;
+    partTagsStorage.clear();
+    patternLengthsStorage.clear();
+    partsCountsStorage.clear();
+    windowOffsetsStorage.assign(1, 0);
+    for (size_t pattern = 0; pattern < patterns.size(); ++pattern)
+    {
+      vector<Substring> substrings;
+      Split(patterns[pattern], substrings, WILDCARD);
+      for (size_t part = 0; part < substrings.size(); ++part)
+      {
+        PatternPartTag partTag;
+        partTag.pattern = pattern;
+        partTag.lastLetterOffset = substrings[part].positionInPattern + 
+          substrings[part].patternPart.size() - 1;
+        partTagsStorage.push_back(partTag);
+        allParts.push_back(substrings[part].patternPart);
+      }
+      patternLengthsStorage.push_back(patterns[pattern].size());
+      partsCountsStorage.push_back(substrings.size());
+      windowOffsetsStorage.push_back(windowOffsetsStorage.back() + patterns[pattern].size());
+    }
+    automat.Init(allParts);
+    partTags = ArrayRef<PatternPartTag>(partTagsStorage);
+    patternLengths = ArrayRef<int>(patternLengthsStorage);
+    partsCounts = ArrayRef<int>(partsCountsStorage);
+    windowOffsets = ArrayRef<int>(windowOffsetsStorage);
+  }
+
+  bool Save(const char * fileName) const
+  {
+    FILE * file = fopen(fileName, "wb");
+    if (NULL == file)
+    {
+      return false;
+    }
+    int header[] = { COMPILED_BATCH_MAGIC, COMPILED_BATCH_VERSION, 
+      static_cast<int>(patternLengths.size()) };
+    fwrite(header, sizeof(header), 1, file);
+    automat.Save(file);
+    WriteArray(file, partTags);
+    WriteArray(file, patternLengths);
+    WriteArray(file, partsCounts);
+    WriteArray(file, windowOffsets);
+    bool written = 0 == ferror(file);
+    return 0 == fclose(file) && written;
+  }
+
+  // Every part tag must point into a pattern and into its window, the
+  // windows must follow each other and each pattern must own as many parts
+  // as it counts
+  bool TablesAreConsistent() const
+  {
+    size_t patternsCount = patternLengths.size();
+    if (0 != windowOffsets[0])
+    {
+      return false;
+    }
+    for (size_t pattern = 0; pattern < patternsCount; ++pattern)
+    {
+      if (patternLengths[pattern] < 0 || partsCounts[pattern] < 0 ||
+        static_cast<long long>(windowOffsets[pattern + 1]) != 
+        static_cast<long long>(windowOffsets[pattern]) + patternLengths[pattern])
+      {
+        return false;
+      }
+    }
+    vector<int> partsFound(patternsCount, 0);
+    for (size_t part = 0; part < partTags.size(); ++part)
+    {
+      const PatternPartTag & partTag = partTags[part];
+      if (partTag.pattern < 0 || static_cast<size_t>(partTag.pattern) >= patternsCount ||
+        partTag.lastLetterOffset < 0 || 
+        partTag.lastLetterOffset >= patternLengths[partTag.pattern])
+      {
+        return false;
+      }
+      ++partsFound[partTag.pattern];
+    }
+    for (size_t pattern = 0; pattern < patternsCount; ++pattern)
+    {
+      if (partsFound[pattern] != partsCounts[pattern])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Maps a file written by Save; all arrays are used in place, so loading
+  // costs one mmap call whatever the number of patterns
+  bool Load(const char * fileName)
+  {
+    if (!mapping.Open(fileName, MADV_RANDOM))
+    {
+      return false;
+    }
+    const char * position = mapping.GetBegin();
+    ArrayRef<int> header;
+    if (!ReadArray(position, mapping.GetEnd(), 3, header) || 
+      COMPILED_BATCH_MAGIC != header[0] || COMPILED_BATCH_VERSION != header[1] ||
+      header[2] < 0 || !automat.Load(position, mapping.GetEnd()))
+    {
+      return false;
+    }
+    size_t patternsCount = static_cast<size_t>(header[2]);
+    return ReadArray(position, mapping.GetEnd(), 
+        static_cast<size_t>(automat.GetPatternsCount()), partTags) &&
+      ReadArray(position, mapping.GetEnd(), patternsCount, patternLengths) &&
+      ReadArray(position, mapping.GetEnd(), patternsCount, partsCounts) &&
+      ReadArray(position, mapping.GetEnd(), patternsCount + 1, windowOffsets) &&
+      TablesAreConsistent();
+  }
+
+  // Single pass over the text. A counter slot is reset lazily when it is
+  // taken over by a new start position, and a start position is reported
+  // when its last part is found, so the work per letter does not depend on
+  // the number of patterns.
+  vector< vector<long long> > FindOccurences(const char * textBegin, const char * textEnd) const
+  {
+    ptrdiff_t textLength = textEnd - textBegin;
+    vector< vector<long long> > positions(patternLengths.size());
+    int windowsSize = windowOffsets[patternLengths.size()];
+    vector<int> counters(windowsSize, 0);
+    vector<long long> slotStarts(windowsSize, -1);
+    for (size_t pattern = 0; pattern < patternLengths.size(); ++pattern)
+    {
+      if (0 == partsCounts[pattern])
+      {
+        for (ptrdiff_t start = 0; start + patternLengths[pattern] <= textLength; ++start)
+        {
+          positions[pattern].push_back(start);
+        }
+      }
+    }
+    int state = INITIAL_STATE;
+    for (ptrdiff_t letterPosition = 0; letterPosition < textLength; ++letterPosition)
+    {
+      state = automat.MakeTransition(state, textBegin[letterPosition]);
+      for (int outputState = state; INITIAL_STATE != outputState; 
+        outputState = automat.GetOutputLink(outputState))
+      {
+        for (const int * label = automat.GetLabelsBegin(outputState);
+          label != automat.GetLabelsEnd(outputState); ++label)
+        {
+          const PatternPartTag & partTag = partTags[*label];
+          ptrdiff_t start = letterPosition - partTag.lastLetterOffset;
+          if (start < 0 || start + patternLengths[partTag.pattern] > textLength)
+          {
+            continue;
+          }
+          int slot = windowOffsets[partTag.pattern] + start % patternLengths[partTag.pattern];
+          if (slotStarts[slot] != start)
+          {
+            slotStarts[slot] = start;
+            counters[slot] = 0;
+          }
+          if (++counters[slot] == partsCounts[partTag.pattern])
+          {
+            positions[partTag.pattern].push_back(start);
+          }
+        }
+      }
+    }
+    return positions;
+  }
+
+  vector< vector<long long> > FindOccurences(const string & text) const
+  {
+    return FindOccurences(text.data(), text.data() + text.size());
+  }
+};
+
+const char * SkipSpaces(const char * position, const char * end)
+{
+  while (position != end && isspace(static_cast<unsigned char>(*position)))
+  {
+    ++position;
+  }
+  return position;
+}
+
+const char * SkipWord(const char * position, const char * end)
+{
+  while (position != end && !isspace(static_cast<unsigned char>(*position)))
+  {
+    ++position;
+  }
+  return position;
+}
+
+template<typename T>
+void PrintVector(const vector<T> & vectorToPrint, BufferedWriter & writer)
+{
+  writer.WriteNumber(vectorToPrint.size());
+  writer.WriteChar('\n');
+  for (size_t counter = 0; counter < vectorToPrint.size(); ++counter)
+  {
+    writer.WriteNumber(vectorToPrint[counter]);
+    writer.WriteChar(' ');
+  }
+  writer.WriteChar('\n');
+}
+
+int MatchMappedFile(const char * fileName, int threadsCount)
+{
+  MappedFile file;
+  if (!file.Open(fileName))
+  {
+    std::cerr << "can not open " << fileName << endl;
+    return 1;
+  }
+  const char * patternBegin = SkipSpaces(file.GetBegin(), file.GetEnd());
+  const char * patternEnd = SkipWord(patternBegin, file.GetEnd());
+  const char * textBegin = SkipSpaces(patternEnd, file.GetEnd());
+  const char * textEnd = SkipWord(textBegin, file.GetEnd());
+  string pattern(patternBegin, patternEnd);
+  BufferedWriter writer(stdout);
+  if (1 == threadsCount)
+  {
+    PrintVector(FindOccurencesWithBestEngine(textBegin, textEnd, pattern), writer);
+  }
+  else
+  {
+    PrintVector(FindOccurencesParallel(textBegin, textEnd, pattern, threadsCount), writer);
+  }
+  return 0;
+}
+
+vector<string> ReadPatterns()
+{
+  int patternsCount;
+  cin >> patternsCount;
+  vector<string> patterns(patternsCount);
+  for (int pattern = 0; pattern < patternsCount; ++pattern)
+  {
+    cin >> patterns[pattern];
+  }
+  return patterns;
+}
+
+int CompileBatch(const char * fileName)
+{
+  WildcardPatternBatch batch;
+  batch.Init(ReadPatterns());
+  if (!batch.Save(fileName))
+  {
+    std::cerr << "can not write " << fileName << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int MatchBatch(const char * compiledFileName)
+{
+  WildcardPatternBatch batch;
+  if (NULL == compiledFileName)
+  {
+    batch.Init(ReadPatterns());
+  }
+  else if (!batch.Load(compiledFileName))
+  {
+    std::cerr << "can not load " << compiledFileName << endl;
+    return 1;
+  }
+  string text;
+  cin >> text;
+  vector< vector<long long> > occurrences = batch.FindOccurences(text);
+  BufferedWriter writer(stdout);
+  for (size_t pattern = 0; pattern < occurrences.size(); ++pattern)
+  {
+    PrintVector(occurrences[pattern], writer);
+  }
+  return 0;
+}
+
+int MatchStream(const char * fileName)
+{
+  std::ios_base::sync_with_stdio(false);
+  std::ifstream file;
+  if (NULL != fileName)
+  {
+    file.open(fileName, std::ios_base::in | std::ios_base::binary);
+    if (!file)
+    {
+      std::cerr << "can not open " << fileName << endl;
+      return 1;
+    }
+  }
+  BufferedWriter writer(stdout);
+  PrintingMatchHandler printingMatchHandler(writer);
+  FindOccurencesInStream(NULL != fileName ? file : cin, printingMatchHandler);
+  writer.WriteChar('\n');
+  writer.WriteNumber(printingMatchHandler.GetMatchesCount());
+  writer.WriteChar('\n');
+  return 0;
+}
+
+int MatchIgnoringCase()
+{
+  string pattern;
+  cin >> pattern;
+  string text;
+  cin >> text;
+  BufferedWriter writer(stdout);
+  PrintVector(FindOccurences<BasicFlatAutomat<CaseInsensitiveAlphabet> >(text, pattern), writer);
+  return 0;
+}
+
+// The pattern is the first line and the text is every byte after it,
+// whitespace and zero bytes included
+int MatchBytes()
+{
+  string pattern;
+  std::getline(cin, pattern);
+  string text((std::istreambuf_iterator<char>(cin)), std::istreambuf_iterator<char>());
+  BufferedWriter writer(stdout);
+  PrintVector(FindOccurences<BasicFlatAutomat<ByteAlphabet> >(text, pattern), writer);
+  return 0;
+}
+
+const char BENCHMARK_PATTERN[] = "abca??dacb";
+const int BENCHMARK_LETTERS_COUNT = 4;
+const long long DEFAULT_BENCHMARK_TEXT_LENGTH = 100000000;
+
+// Random text over the letters of BENCHMARK_PATTERN, the same for a given length
+string GenerateBenchmarkText(long long length)
+{
+  std::mt19937 random(static_cast<unsigned int>(length));
+  string text(length, FIRST_LETTER);
+  for (long long position = 0; position < length; ++position)
+  {
+    text[position] = static_cast<char>(FIRST_LETTER + random() % BENCHMARK_LETTERS_COUNT);
+  }
+  return text;
+}
+
+double GetSecondsSince(const std::chrono::steady_clock::time_point & start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Matches BENCHMARK_PATTERN with one automaton and prints the measurement as
+// a JSON object
+template <class PatternAutomat>
+vector<long long> BenchmarkAutomat(const char * automatName, const string & text, bool isFirst)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  vector<long long> positions = FindOccurences<PatternAutomat>(text, BENCHMARK_PATTERN);
+  double seconds = GetSecondsSince(start);
+  printf("%s\n  {\"automaton\": \"%s\", \"text_length\": %lld, \"ns_per_letter\": %.3f, "
+    "\"megabytes_per_second\": %.1f, \"matches\": %lld}",
+    isFirst ? "" : ",", automatName, static_cast<long long>(text.size()),
+    seconds * 1e9 / text.size(), text.size() / seconds / 1e6,
+    static_cast<long long>(positions.size()));
+  fflush(stdout);
+  return positions;
+}
+
+// Prints a JSON array comparing the flat automaton with the trie one on
+// texts of 10^6, 10^7, ... letters up to maxTextLength. Fails if the two
+// find different occurrences.
+int BenchmarkAutomata(long long maxTextLength)
+{
+  printf("[");
+  bool agree = true;
+  for (long long textLength = 1000000; textLength <= maxTextLength; textLength *= 10)
+  {
+    string text = GenerateBenchmarkText(textLength);
+    vector<long long> flatPositions = 
+      BenchmarkAutomat<FlatAutomat>("flat", text, 1000000 == textLength);
+    vector<long long> triePositions = 
+      BenchmarkAutomat< Automat<CompressedAlphabet> >("trie", text, false);
+    agree = agree && flatPositions == triePositions;
+  }
+  printf("\n]\n");
+  if (!agree)
+  {
+    std::cerr << "the automata found different occurrences" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+// Prints a JSON array with the throughput of FindOccurencesParallel on one
+// random text for 1, 2, 4, ... up to maxThreadsCount threads, and the
+// speedup over one thread. Fails if any thread count changes the result.
+int BenchmarkThreads(long long textLength, int maxThreadsCount)
+{
+  string text = GenerateBenchmarkText(textLength);
+  vector<long long> singleThreadPositions;
+  double singleThreadSeconds = 0;
+  bool agree = true;
+  printf("[");
+  for (int threadsCount = 1; threadsCount < 2 * maxThreadsCount; threadsCount *= 2)
+  {
+    int runThreadsCount = std::min(threadsCount, maxThreadsCount);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    vector<long long> positions = FindOccurencesParallel(text.data(), 
+      text.data() + text.size(), BENCHMARK_PATTERN, runThreadsCount);
+    double seconds = GetSecondsSince(start);
+    if (1 == threadsCount)
+    {
+      singleThreadPositions.swap(positions);
+      singleThreadSeconds = seconds;
+    }
+    else
+    {
+      agree = agree && positions == singleThreadPositions;
+    }
+    printf("%s\n  {\"threads\": %d, \"text_length\": %lld, \"seconds\": %.3f, "
+      "\"megabytes_per_second\": %.1f, \"speedup\": %.2f}",
+      1 == threadsCount ? "" : ",", runThreadsCount, textLength, seconds, 
+      textLength / seconds / 1e6, singleThreadSeconds / seconds);
+    fflush(stdout);
+  }
+  printf("\n]\n");
+  if (!agree)
+  {
+    std::cerr << "the thread counts found different occurrences" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+// Collects the results of the self-test checks, printing one line per check
+class SelfTestReport
+{
+  int failuresCount;
+public:
+  SelfTestReport() : failuresCount(0)
+  {
+  }
+
+  void Check(bool passed, const char * checkName)
+  {
+    cout << (passed ? "ok " : "FAILED ") << checkName << endl;
+    if (!passed)
+    {
+      ++failuresCount;
+    }
+  }
+
+  int GetFailuresCount() const
+  {
+    return failuresCount;
+  }
+};
+
+// Writes a sparse file whose only match starts past the 2 GiB mark, maps it
+// the same way MatchMappedFile does and runs every engine over it
+void CheckLargeFile(const string & directory, SelfTestReport & report)
+{
+  const long long MATCH_POSITION = (1LL << 31) + (1LL << 28);
+  const string pattern = "b?d";
+  const string matchedWord = "bcd";
+  string fileName = directory + "/2-1-self-test.txt";
+  FILE * file = fopen(fileName.c_str(), "wb");
+  if (NULL == file)
+  {
+    report.Check(false, "large file: can not create");
+    return;
+  }
+  bool written = fputs((pattern + "\n").c_str(), file) >= 0 &&
+    0 == fseeko(file, static_cast<off_t>(pattern.size() + 1 + MATCH_POSITION), SEEK_SET) &&
+    fputs((matchedWord + "\n").c_str(), file) >= 0;
+  written = (0 == fclose(file)) && written;
+  MappedFile mappedFile;
+  bool mapped = written && mappedFile.Open(fileName.c_str());
+  unlink(fileName.c_str());
+  if (!mapped)
+  {
+    report.Check(false, "large file: can not write and map");
+    return;
+  }
+  const char * patternBegin = SkipSpaces(mappedFile.GetBegin(), mappedFile.GetEnd());
+  const char * patternEnd = SkipWord(patternBegin, mappedFile.GetEnd());
+  const char * textBegin = SkipSpaces(patternEnd, mappedFile.GetEnd());
+  const char * textEnd = SkipWord(textBegin, mappedFile.GetEnd());
+  const vector<long long> expected(1, MATCH_POSITION);
+  report.Check(string(patternBegin, patternEnd) == pattern && 
+    textEnd - textBegin == MATCH_POSITION + static_cast<long long>(matchedWord.size()),
+    "large file: parsing");
+  report.Check(FindOccurencesWithBestEngine(textBegin, textEnd, pattern) == expected,
+    "large file: best engine");
+  report.Check(FindOccurencesParallel(textBegin, textEnd, pattern, 2) == expected,
+    "large file: automaton with two threads");
+  report.Check(FindOccurencesShiftAnd(textBegin, textEnd, pattern) == expected,
+    "large file: shift-and");
+  report.Check(FindOccurencesVectorized(textBegin, textEnd, pattern, AUTOMAT_ENGINE) == expected,
+    "large file: direct comparison");
+#if defined(__x86_64__) || defined(__i386__)
+  report.Check(FindOccurencesVectorized(textBegin, textEnd, pattern, SSE_ENGINE) == expected,
+    "large file: sse");
+  if (__builtin_cpu_supports("avx2"))
+  {
+    report.Check(FindOccurencesVectorized(textBegin, textEnd, pattern, AVX2_ENGINE) == expected,
+      "large file: avx2");
+  }
+#endif
+  WildcardPatternBatch batch;
+  batch.Init(vector<string>(1, pattern));
+  report.Check(batch.FindOccurences(textBegin, textEnd) == vector< vector<long long> >(1, expected),
+    "large file: batch");
+}
+
+// Bytes taken from the heap and not yet given back, or -1 where the C
+// library can not tell
+long long GetHeapBytesInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (2 == __GLIBC__ && __GLIBC_MINOR__ >= 33))
+  return static_cast<long long>(mallinfo2().uordblks);
+#else
+  return -1;
+#endif
+}
+
+// Builds the trie automaton again and again for more and more patterns and
+// tells if every build took one arena block, that is one malloc, for its
+// nodes and labels whatever their number
+bool BuildTrieAutomataInOneBlock(const vector<string> & patterns)
+{
+  bool singleBlock = true;
+  Automat<CompressedAlphabet> rebuiltAutomat;
+  for (size_t patternsCount = 1; patternsCount <= patterns.size(); patternsCount *= 10)
+  {
+    vector<string> someOfPatterns(patterns.begin(), patterns.begin() + patternsCount);
+    Automat<CompressedAlphabet> automat;
+    automat.Init(someOfPatterns);
+    rebuiltAutomat.Init(someOfPatterns);
+    singleBlock = singleBlock && 1 == automat.GetArenaBlocksCount() && 
+      1 == rebuiltAutomat.GetArenaBlocksCount();
+  }
+  return singleBlock;
+}
+
+// The automata must also give everything back when destroyed. The first
+// round is not measured: it fills the caches of freed chunks that malloc
+// keeps and still reports as in use.
+void CheckTrieAllocations(SelfTestReport & report)
+{
+  const int MAX_PATTERNS_COUNT = 10000;
+  const int MAX_PATTERN_LENGTH = 20;
+  std::mt19937 random(MAX_PATTERNS_COUNT);
+  vector<string> patterns(MAX_PATTERNS_COUNT);
+  for (int pattern = 0; pattern < MAX_PATTERNS_COUNT; ++pattern)
+  {
+    patterns[pattern].resize(1 + random() % MAX_PATTERN_LENGTH);
+    for (size_t position = 0; position < patterns[pattern].size(); ++position)
+    {
+      patterns[pattern][position] = static_cast<char>(FIRST_LETTER + random() % 26);
+    }
+  }
+  bool singleBlock = BuildTrieAutomataInOneBlock(patterns);
+  long long heapBytesBefore = GetHeapBytesInUse();
+  singleBlock = BuildTrieAutomataInOneBlock(patterns) && singleBlock;
+  long long heapBytesAfter = GetHeapBytesInUse();
+  report.Check(singleBlock, "trie automaton: one malloc for its nodes and labels");
+  if (heapBytesBefore >= 0)
+  {
+    report.Check(heapBytesAfter == heapBytesBefore, "trie automaton: no leaks");
+  }
+}
+
+string FoldCase(string letters)
+{
+  for (size_t position = 0; position < letters.size(); ++position)
+  {
+    if ('A' <= letters[position] && letters[position] <= 'Z')
+    {
+      letters[position] = letters[position] - 'A' + FIRST_LETTER;
+    }
+  }
+  return letters;
+}
+
+// Random patterns and texts with letters of both cases, digits, zero bytes,
+// newlines and bytes above 127, matched by the byte and the case-insensitive
+// automata
+void CheckAlphabets(SelfTestReport & report)
+{
+  const int CASES_COUNT = 1000;
+  const char PATTERN_LETTERS[] = { 'a', 'A', 'b', '1', '-', '\0', '\n', '\xff', WILDCARD };
+  const char TEXT_LETTERS[] = { 'a', 'A', 'b', 'B', '1', '-', '\0', '\n', '\xff' };
+  std::mt19937 random(CASES_COUNT);
+  bool bytesAgree = true;
+  bool foldedAgree = true;
+  for (int counter = 0; counter < CASES_COUNT; ++counter)
+  {
+    string pattern(1 + random() % 6, WILDCARD);
+    for (size_t position = 0; position < pattern.size(); ++position)
+    {
+      pattern[position] = PATTERN_LETTERS[random() % sizeof(PATTERN_LETTERS)];
+    }
+    string text(random() % 64, FIRST_LETTER);
+    for (size_t position = 0; position < text.size(); ++position)
+    {
+      text[position] = TEXT_LETTERS[random() % sizeof(TEXT_LETTERS)];
+    }
+    bytesAgree = bytesAgree && FindOccurences< BasicFlatAutomat<ByteAlphabet> >(text, pattern) == 
+      FindOccurencesVectorized(text.data(), text.data() + text.size(), pattern, AUTOMAT_ENGINE);
+    string foldedText = FoldCase(text);
+    foldedAgree = foldedAgree && 
+      FindOccurences< BasicFlatAutomat<CaseInsensitiveAlphabet> >(text, pattern) == 
+      FindOccurencesVectorized(foldedText.data(), foldedText.data() + foldedText.size(), 
+        FoldCase(pattern), AUTOMAT_ENGINE);
+  }
+  report.Check(bytesAgree, "byte alphabet agrees with direct comparison");
+  report.Check(foldedAgree, "case-insensitive alphabet agrees with direct comparison");
+}
+
+// Random short patterns and texts over two letters, matched by both
+// automata and by direct comparison
+void CheckAutomataAgree(SelfTestReport & report)
+{
+  const int CASES_COUNT = 1000;
+  std::mt19937 random(CASES_COUNT);
+  bool agree = true;
+  for (int counter = 0; counter < CASES_COUNT && agree; ++counter)
+  {
+    string pattern(1 + random() % 8, WILDCARD);
+    for (size_t position = 0; position < pattern.size(); ++position)
+    {
+      pattern[position] = "ab?"[random() % 3];
+    }
+    string text(random() % 64, FIRST_LETTER);
+    for (size_t position = 0; position < text.size(); ++position)
+    {
+      text[position] = "ab"[random() % 2];
+    }
+    vector<long long> expected = FindOccurencesVectorized(text.data(), 
+      text.data() + text.size(), pattern, AUTOMAT_ENGINE);
+    agree = FindOccurences<FlatAutomat>(text, pattern) == expected &&
+      FindOccurences< Automat<CompressedAlphabet> >(text, pattern) == expected;
+  }
+  report.Check(agree, "flat and trie automata agree with direct comparison");
+}
+
+bool LoadsAsBatch(const string & fileName, const string & contents)
+{
+  {
+    std::ofstream file(fileName.c_str(), std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), contents.size());
+  }
+  WildcardPatternBatch batch;
+  return batch.Load(fileName.c_str());
+}
+
+// Saves a compiled batch and loads copies of it that are cut short or have
+// one word set to -1; no such copy may load
+void CheckCorruptedBatches(const string & directory, SelfTestReport & report)
+{
+  const char * const PATTERNS[] = { "ab?a", "??b", "bab", "a", "?" };
+  WildcardPatternBatch batch;
+  batch.Init(vector<string>(PATTERNS, PATTERNS + sizeof(PATTERNS) / sizeof(PATTERNS[0])));
+  string fileName = directory + "/2-1-self-test.bin";
+  if (!batch.Save(fileName.c_str()))
+  {
+    report.Check(false, "compiled batch: can not save");
+    return;
+  }
+  string compiled;
+  {
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    compiled.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  bool rejected = true;
+  for (size_t size = 0; size < compiled.size() && rejected; ++size)
+  {
+    rejected = !LoadsAsBatch(fileName, compiled.substr(0, size));
+  }
+  const int CORRUPTED_WORD = -1;
+  for (size_t offset = 0; offset + sizeof(int) <= compiled.size() && rejected; 
+    offset += sizeof(int))
+  {
+    string corrupted = compiled;
+    corrupted.replace(offset, sizeof(int), 
+      reinterpret_cast<const char *>(&CORRUPTED_WORD), sizeof(int));
+    rejected = !LoadsAsBatch(fileName, corrupted);
+  }
+  bool loaded = LoadsAsBatch(fileName, compiled);
+  unlink(fileName.c_str());
+  report.Check(loaded, "compiled batch: loads intact");
+  report.Check(rejected, "compiled batch: rejects truncated and corrupted files");
+}
+
+// The checks that need more than a pattern and a text on stdin. Small
+// files go to the scratch directory or to the system one; the checks that
+// write a file of more than 2 GiB only run if a scratch directory is given
+int RunSelfTest(const char * scratchDirectory)
+{
+  SelfTestReport report;
+  CheckTrieAllocations(report);
+  CheckAutomataAgree(report);
+  CheckAlphabets(report);
+  CheckCorruptedBatches(NULL != scratchDirectory ? scratchDirectory : P_tmpdir, report);
+  if (NULL != scratchDirectory)
+  {
+    CheckLargeFile(scratchDirectory, report);
+  }
+  return report.GetFailuresCount() > 0 ? 1 : 0;
+}
+
+// Usage: 2-1 [--stream | --threads count] [file]
+//        2-1 --ignore-case | --bytes
+//        2-1 --batch [compiled] | --compile compiled
+//        2-1 --self-test [scratch directory]
+//        2-1 --benchmark-automata [max text length]
+//        2-1 --benchmark-threads [text length [max threads]]
+// The input (pattern, then text) is read from the file if one is given and
+// from stdin otherwise. A file is memory-mapped and matched in place. In
+// streaming mode the text is read chunk by chunk, positions are printed as
+// soon as they are confirmed and are followed by their count. With --threads
+// the search is split between count threads (0 means one per core).
+// With --ignore-case letters of both the pattern and the text are folded.
+// With --bytes the pattern is the first line of the input and the text is
+// all the bytes that follow it, so the text may hold any byte.
+// Batch mode reads the number of patterns, the patterns and the text, and
+// prints the occurrences of every pattern found in one pass. --compile
+// stores the automaton built for the patterns, and --batch with that file
+// maps it instead of reading and compiling the patterns again.
+// --self-test prints ok or FAILED for each of its checks and fails if any
+// check did. --benchmark-automata reads nothing and prints the throughput
+// of the flat and the trie automata on random texts as JSON.
+// --benchmark-threads does the same for the threaded search with a growing
+// number of threads, up to one per core by default.
+int main(int argc, char * argv[]) 
+{
+  string mode = (argc > 1) ? argv[1] : "";
+  if ("--stream" == mode)
+  {
+    return MatchStream(argc > 2 ? argv[2] : NULL);
+  }
+  if ("--batch" == mode)
+  {
+    return MatchBatch(argc > 2 ? argv[2] : NULL);
+  }
+  if ("--compile" == mode && argc > 2)
+  {
+    return CompileBatch(argv[2]);
+  }
+  if ("--ignore-case" == mode)
+  {
+    return MatchIgnoringCase();
+  }
+  if ("--bytes" == mode)
+  {
+    return MatchBytes();
+  }
+  if ("--self-test" == mode)
+  {
+    return RunSelfTest(argc > 2 ? argv[2] : NULL);
+  }
+  if ("--benchmark-automata" == mode)
+  {
+    return BenchmarkAutomata(argc > 2 ? atoll(argv[2]) : DEFAULT_BENCHMARK_TEXT_LENGTH);
+  }
+  if ("--benchmark-threads" == mode)
+  {
+    return BenchmarkThreads(argc > 2 ? atoll(argv[2]) : DEFAULT_BENCHMARK_TEXT_LENGTH,
+      argc > 3 ? atoi(argv[3]) : std::max(1U, std::thread::hardware_concurrency()));
+  }
+  int threadsCount = 1;
+  int fileArgument = 1;
+  if ("--threads" == mode && argc > 2)
+  {
+    threadsCount = atoi(argv[2]);
+    fileArgument = 3;
+  }
+  if (argc > fileArgument)
+  {
+    return MatchMappedFile(argv[fileArgument], threadsCount);
+  }
+  string pattern;
+  cin >> pattern;
+  string text;
+  cin >> text;
+  vector<long long> occurrences;
+  if ("--threads" == mode)
+  {
+    occurrences = FindOccurencesParallel(text, pattern, threadsCount);
+  }
+  else
+  {
+    occurrences = FindOccurencesWithBestEngine(text.data(), text.data() + text.size(), pattern);
+  }
+  BufferedWriter writer(stdout);
+  PrintVector(occurrences, writer);
   return 0;
 }
@@ -1,13 +1,44 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <iterator>
+#include <utility>
+#include <thread>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <stdexcept>
+#include <cstring>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <climits>
+#include <random>
+#include <chrono>
+#include <memory>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
 
-using std::cin;
-using std::cout;
-using std::endl;
 using std::vector;
 using std::sort;
 
+// Sums of efficiencies are accumulated in 128 bits, which no roster can
+// overflow, and checked when they are converted back to long
+typedef __int128 EfficiencySum;
+
+long ToEfficiency(EfficiencySum sum)
+{
+    if (sum > LONG_MAX || sum < LONG_MIN)
+        throw std::overflow_error("team efficiency does not fit in 64 bits");
+    return static_cast<long>(sum);
+}
+
 class SoccerPlayer
 {
     long int efficiency_;
@@ -35,6 +66,83 @@ public:
     }
 };
 
+// Players stored column by column; rows are numbered from 0
+class PlayerTable
+{
+    std::vector<long> efficiencies_;
+    std::vector<int> ids_;
+
+public:
+    void Reserve(int playersCount)
+    {
+        efficiencies_.reserve(playersCount);
+        ids_.reserve(playersCount);
+    }
+
+    // The new player's id is its row at the time it is added
+    void Add(long efficiency)
+    {
+        ids_.push_back(ids_.size());
+        efficiencies_.push_back(efficiency);
+    }
+
+    int GetSize() const
+    {
+        return ids_.size();
+    }
+
+    long GetEfficiency(int row) const
+    {
+        return efficiencies_[row];
+    }
+
+    const long *GetEfficiencies() const
+    {
+        return efficiencies_.data();
+    }
+
+    int GetId(int row) const
+    {
+        return ids_[row];
+    }
+
+    // Row i takes the player from row order[i]
+    void Permute(const std::vector<int> &order)
+    {
+        std::vector<long> efficiencies(order.size());
+        std::vector<int> ids(order.size());
+        for (size_t row = 0; row < order.size(); ++row)
+        {
+            efficiencies[row] = efficiencies_[order[row]];
+            ids[row] = ids_[order[row]];
+        }
+        efficiencies_.swap(efficiencies);
+        ids_.swap(ids);
+    }
+};
+
+// Rows of a table, [first, last)
+struct RowRange
+{
+    int first;
+    int last;
+};
+
+class CompareRowsByEfficiency
+{
+    const PlayerTable *table_;
+
+public:
+    explicit CompareRowsByEfficiency(const PlayerTable &table) : table_(&table)
+    {
+    }
+
+    bool operator()(int firstRow, int secondRow) const
+    {
+        return table_->GetEfficiency(firstRow) < table_->GetEfficiency(secondRow);
+    }
+};
+
 class CompareByEfficiency
 {
 public:
@@ -44,6 +152,21 @@ public:
     }
 };
 
+class CompareByCount
+{
+    const std::vector<int> *counts_;
+
+public:
+    explicit CompareByCount(const std::vector<int> &counts) : counts_(&counts)
+    {
+    }
+
+    bool operator()(int firstQuery, int secondQuery) const
+    {
+        return (*counts_)[firstQuery] < (*counts_)[secondQuery];
+    }
+};
+
 class CompareById
 {
 public:
@@ -53,168 +176,2167 @@ public:
     }
 };
 
-template <typename It, class T, class Compare>
-void Merge(It beginFirst, 
-           It endFirst,
-           It beginSecond,
-           It endSecond,
+// Below this length ranges are sorted by insertion
+const int INSERTION_SORT_CUTOFF = 24;
+
+template <typename It, class Compare>
+void InsertionSort(It begin, 
+                   It end,
+                   Compare compare)
+{
+    if (begin == end)
+        return;
+    for (It current = begin + 1; current != end; ++current)
+    {
+        typename std::iterator_traits<It>::value_type value = std::move(*current);
+        It position = current;
+        while (position != begin && compare(value, *(position - 1)))
+        {
+            *position = std::move(*(position - 1));
+            --position;
+        }
+        *position = std::move(value);
+    }
+}
+
+// Moves both sorted ranges into output; on ties the first range goes first
+template <typename InputIt, typename OutputIt, class Compare>
+void Merge(InputIt beginFirst, 
+           InputIt endFirst,
+           InputIt beginSecond,
+           InputIt endSecond,
+           OutputIt outputIt,
            Compare compare) 
 {
-    std::vector<T> result; 
-    It outputIt = beginFirst;
     while (beginFirst != endFirst && beginSecond != endSecond)
-	{
-        if (compare(*beginFirst, *beginSecond))
+    {
+        if (compare(*beginSecond, *beginFirst))
         {
-            result.push_back(*beginFirst);
-            ++beginFirst;
+            *outputIt = std::move(*beginSecond);
+            ++beginSecond;
         }
         else
         {
-            result.push_back(*beginSecond);
-            ++beginSecond;
+            *outputIt = std::move(*beginFirst);
+            ++beginFirst;
         }
+        ++outputIt;
     }
-    while (beginFirst != endFirst)
+    outputIt = std::move(beginFirst, endFirst, outputIt);
+    std::move(beginSecond, endSecond, outputIt);
+}
+
+template <typename It, typename BufferIt, class Compare>
+void MergeSortInPlace(It begin, It end, BufferIt buffer, Compare compare);
+
+// Sorts [begin, end) into the buffer, leaving the source in moved-from state
+template <typename It, typename BufferIt, class Compare>
+void MergeSortToBuffer(It begin, 
+                       It end,
+                       BufferIt buffer,
+                       Compare compare)
+{
+    int length = std::distance(begin, end);
+    if (length < INSERTION_SORT_CUTOFF)
     {
-        result.push_back(*beginFirst);
-        ++beginFirst;
+        InsertionSort(begin, end, compare);
+        std::move(begin, end, buffer);
+        return;
     }
-    while (beginSecond != endSecond)
+    It middle = begin + length / 2;
+    MergeSortInPlace(begin, middle, buffer, compare);
+    MergeSortInPlace(middle, end, buffer + length / 2, compare);
+    Merge(begin, middle, middle, end, buffer, compare);
+}
+
+// Sorts [begin, end) using a buffer of the same length. Levels alternate
+// between the source and the buffer, so nothing is copied back.
+template <typename It, typename BufferIt, class Compare>
+void MergeSortInPlace(It begin, 
+                      It end,
+                      BufferIt buffer,
+                      Compare compare)
+{
+    int length = std::distance(begin, end);
+    if (length < INSERTION_SORT_CUTOFF)
     {
-        result.push_back(*beginSecond);
-        ++beginSecond;
+        InsertionSort(begin, end, compare);
+        return;
     }
-    std::copy(result.begin(), result.end(), outputIt);
+    BufferIt bufferMiddle = buffer + length / 2;
+    BufferIt bufferEnd = buffer + length;
+    MergeSortToBuffer(begin, begin + length / 2, buffer, compare);
+    MergeSortToBuffer(begin + length / 2, end, bufferMiddle, compare);
+    Merge(buffer, bufferMiddle, bufferMiddle, bufferEnd, begin, compare);
+}
+
+// Stable sort; the buffer is grown to the range length if it is shorter
+template<typename It, class T, class Compare, class Allocator>
+void MergeSort(It begin, 
+               It end,
+               std::vector<T, Allocator> &buffer,
+               Compare compare)
+{
+    int length = std::distance(begin, end);
+    if (buffer.size() < static_cast<size_t>(length))
+        buffer.resize(length);
+    MergeSortInPlace(begin, end, buffer.begin(), compare);
 }
 
 template<typename It, class T, class Compare>
 void MergeSort(It begin, 
                It end,
                Compare compare)
- {
+{
+    std::vector<T> buffer;
+    MergeSort<It, T, Compare>(begin, end, buffer, compare);
+}
+
+// Ranges shorter than this are sorted and merged on the calling thread
+const int PARALLEL_GRAIN_SIZE = 1 << 14;
+
+// Returns how many of the first diagonal elements of the stable merge come
+// from the first range (merge path co-ranking)
+template <typename InputIt, class Compare>
+int CoRank(int diagonal,
+           InputIt beginFirst,
+           int lengthFirst,
+           InputIt beginSecond,
+           int lengthSecond,
+           Compare compare)
+{
+    int low = std::max(0, diagonal - lengthSecond);
+    int high = std::min(diagonal, lengthFirst);
+    while (low < high)
+    {
+        int middle = low + (high - low) / 2;
+        if (!compare(beginSecond[diagonal - middle - 1], beginFirst[middle]))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+// Splits the output into equal segments and merges each on its own thread
+template <typename InputIt, typename OutputIt, class Compare>
+void ParallelMerge(InputIt beginFirst, 
+                   InputIt endFirst,
+                   InputIt beginSecond,
+                   InputIt endSecond,
+                   OutputIt outputIt,
+                   Compare compare,
+                   int threadsCount)
+{
+    int lengthFirst = std::distance(beginFirst, endFirst);
+    int lengthSecond = std::distance(beginSecond, endSecond);
+    int length = lengthFirst + lengthSecond;
+    threadsCount = std::min(threadsCount, length / PARALLEL_GRAIN_SIZE);
+    if (threadsCount <= 1)
+    {
+        Merge(beginFirst, endFirst, beginSecond, endSecond, outputIt, compare);
+        return;
+    }
+    std::vector<int> firstSplits(threadsCount + 1);
+    for (int segment = 0; segment <= threadsCount; ++segment)
+    {
+        int diagonal = static_cast<long long>(length) * segment / threadsCount;
+        firstSplits[segment] = CoRank(diagonal, beginFirst, lengthFirst, 
+                                      beginSecond, lengthSecond, compare);
+    }
+    std::vector<std::thread> threads;
+    for (int segment = threadsCount - 1; segment >= 0; --segment)
+    {
+        int diagonal = static_cast<long long>(length) * segment / threadsCount;
+        int nextDiagonal = static_cast<long long>(length) * (segment + 1) / threadsCount;
+        InputIt segmentFirst = beginFirst + firstSplits[segment];
+        InputIt segmentFirstEnd = beginFirst + firstSplits[segment + 1];
+        InputIt segmentSecond = beginSecond + (diagonal - firstSplits[segment]);
+        InputIt segmentSecondEnd = beginSecond + (nextDiagonal - firstSplits[segment + 1]);
+        if (0 == segment)
+        {
+            Merge(segmentFirst, segmentFirstEnd, segmentSecond, segmentSecondEnd, 
+                  outputIt, compare);
+        }
+        else
+        {
+            threads.push_back(std::thread(Merge<InputIt, OutputIt, Compare>, 
+                                          segmentFirst, segmentFirstEnd, 
+                                          segmentSecond, segmentSecondEnd,
+                                          outputIt + diagonal, compare));
+        }
+    }
+    for (size_t thread = 0; thread < threads.size(); ++thread)
+    {
+        threads[thread].join();
+    }
+}
+
+template <typename It, typename BufferIt, class Compare>
+void ParallelMergeSortInPlace(It begin, It end, BufferIt buffer, Compare compare, 
+                              int threadsCount);
+
+// The halves are sorted concurrently, each with its share of the threads
+template <typename It, typename BufferIt, class Compare>
+void ParallelMergeSortToBuffer(It begin, 
+                               It end,
+                               BufferIt buffer,
+                               Compare compare,
+                               int threadsCount)
+{
     int length = std::distance(begin, end);
-    if (length <= 1)
+    if (threadsCount <= 1 || length < PARALLEL_GRAIN_SIZE)
+    {
+        MergeSortToBuffer(begin, end, buffer, compare);
         return;
+    }
     It middle = begin + length / 2;
-    MergeSort<It, T, Compare>(begin, middle, compare);
-    MergeSort<It, T, Compare>(middle, end, compare);
-    Merge<It, T, Compare>(begin, middle, middle, end, compare);
-    return;
-} 
+    std::thread firstHalf(ParallelMergeSortInPlace<It, BufferIt, Compare>, 
+                          begin, middle, buffer, compare, threadsCount / 2);
+    ParallelMergeSortInPlace(middle, end, buffer + length / 2, compare, 
+                             threadsCount - threadsCount / 2);
+    firstHalf.join();
+    ParallelMerge(begin, middle, middle, end, buffer, compare, threadsCount);
+}
 
-std::vector<SoccerPlayer> ReadSoccerPlayers()
+template <typename It, typename BufferIt, class Compare>
+void ParallelMergeSortInPlace(It begin, 
+                              It end,
+                              BufferIt buffer,
+                              Compare compare,
+                              int threadsCount)
 {
-    std::vector<SoccerPlayer> players;
-    int playersCount;
-    cin >> playersCount;
-    for (int cnt = 0; cnt < playersCount; ++cnt)
+    int length = std::distance(begin, end);
+    if (threadsCount <= 1 || length < PARALLEL_GRAIN_SIZE)
     {
-		long efficiency;
-        cin >> efficiency;
-		SoccerPlayer soccerPlayer;
-        soccerPlayer.SetEfficiency(efficiency);
-        soccerPlayer.SetId(players.size());
-        players.push_back(soccerPlayer);
+        MergeSortInPlace(begin, end, buffer, compare);
+        return;
     }
-    return players;
+    It middle = begin + length / 2;
+    BufferIt bufferMiddle = buffer + length / 2;
+    BufferIt bufferEnd = buffer + length;
+    std::thread firstHalf(ParallelMergeSortToBuffer<It, BufferIt, Compare>, 
+                          begin, middle, buffer, compare, threadsCount / 2);
+    ParallelMergeSortToBuffer(middle, end, bufferMiddle, compare, 
+                              threadsCount - threadsCount / 2);
+    firstHalf.join();
+    ParallelMerge(buffer, bufferMiddle, bufferMiddle, bufferEnd, begin, compare, 
+                  threadsCount);
 }
 
-bool OnePlayerEfficiencyLessOrEqualThenSumOthers(SoccerPlayer onePlayer,
-                                                 SoccerPlayer firstAnotherPlayer,
-                                                 SoccerPlayer secondAnotherPlayer)
+// Gives the same order as MergeSort; 0 threads means one per core
+template<typename It, class T, class Compare>
+void ParallelMergeSort(It begin, 
+                       It end,
+                       Compare compare,
+                       int threadsCount)
 {
-    return onePlayer.GetEfficiency() <=
-           firstAnotherPlayer.GetEfficiency() +
-           secondAnotherPlayer.GetEfficiency();
+    if (threadsCount <= 0)
+        threadsCount = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<T> buffer(std::distance(begin, end));
+    ParallelMergeSortInPlace(begin, end, buffer.begin(), compare, threadsCount);
 }
 
-std::vector<SoccerPlayer> BuildSoccerTeam(std::vector<SoccerPlayer> players)
+// Key extractors map a player to an unsigned key with the same order
+class EfficiencyKey
 {
-    std::vector<SoccerPlayer> team;
-    CompareByEfficiency compareByEfficiency;
-    MergeSort<std::vector<SoccerPlayer>::iterator, SoccerPlayer, CompareByEfficiency>
-        (players.begin(), 
-         players.end(),
-         compareByEfficiency);
-    int currentTeamBegin = 0;
-    int possiblePlayersRight = 0;
-    int possiblePlayersLeft = 0;
-    int currentTeamEnd = 0;
-    long possiblePlayersSum = players[0].GetEfficiency();
-    long maxSumEffisiency = players[0].GetEfficiency();
-    int playersCount = players.size();
-    while (playersCount - 1 != possiblePlayersRight)
+public:
+    unsigned long long operator()(const SoccerPlayer &player) const
     {
-        possiblePlayersRight++;
-        possiblePlayersSum += players[possiblePlayersRight].GetEfficiency();
-        if (possiblePlayersRight - currentTeamBegin < 2)
+        // Flipping the sign bit puts negative values first
+        return static_cast<unsigned long long>(player.GetEfficiency()) ^ (1ULL << 63);
+    }
+};
+
+class RowEfficiencyKey
+{
+    const PlayerTable *table_;
+
+public:
+    explicit RowEfficiencyKey(const PlayerTable &table) : table_(&table)
+    {
+    }
+
+    unsigned long long operator()(int row) const
+    {
+        return static_cast<unsigned long long>(table_->GetEfficiency(row)) ^ (1ULL << 63);
+    }
+};
+
+class IdKey
+{
+public:
+    unsigned long long operator()(const SoccerPlayer &player) const
+    {
+        return player.GetId();
+    }
+};
+
+const int RADIX_DIGIT_BITS = 11;
+const int RADIX_BUCKETS_COUNT = 1 << RADIX_DIGIT_BITS;
+const int RADIX_PASSES_COUNT = (64 + RADIX_DIGIT_BITS - 1) / RADIX_DIGIT_BITS;
+const int RADIX_PREFETCH_DISTANCE = 16;
+
+template <class KeyExtractor, class T>
+int GetDigit(KeyExtractor key, const T &value, int pass)
+{
+    return (key(value) >> (pass * RADIX_DIGIT_BITS)) & (RADIX_BUCKETS_COUNT - 1);
+}
+
+// Moves every element to the slot its digit reserves in offsets; the
+// destination of an element a few steps ahead is prefetched
+template <typename InputIt, typename OutputIt, class KeyExtractor>
+void RadixScatter(InputIt begin, 
+                  InputIt end,
+                  OutputIt output,
+                  int *offsets,
+                  int pass,
+                  KeyExtractor key)
+{
+    for (InputIt current = begin; current != end; ++current)
+    {
+        if (end - current > RADIX_PREFETCH_DISTANCE)
         {
-            maxSumEffisiency += players[possiblePlayersRight].GetEfficiency();
-            currentTeamEnd = possiblePlayersRight;
-            possiblePlayersLeft = currentTeamBegin;
+            int ahead = GetDigit(key, current[RADIX_PREFETCH_DISTANCE], pass);
+            __builtin_prefetch(&output[offsets[ahead]], 1);
+        }
+        output[offsets[GetDigit(key, *current, pass)]++] = std::move(*current);
+    }
+}
+
+// Stable LSD radix sort by an integral key. All digit histograms are counted
+// in one pass, and digits that are equal for every element are skipped.
+// The histograms are allocated like the buffer.
+template<typename It, class T, class KeyExtractor, class Allocator>
+void RadixSort(It begin, 
+               It end,
+               std::vector<T, Allocator> &buffer,
+               KeyExtractor key)
+{
+    int length = std::distance(begin, end);
+    if (length <= 1)
+        return;
+    if (buffer.size() < static_cast<size_t>(length))
+        buffer.resize(length);
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<int> IntAllocator;
+    std::vector<int, IntAllocator> histograms(RADIX_PASSES_COUNT * RADIX_BUCKETS_COUNT, 0, 
+                                              IntAllocator(buffer.get_allocator()));
+    for (It current = begin; current != end; ++current)
+    {
+        for (int pass = 0; pass < RADIX_PASSES_COUNT; ++pass)
+        {
+            ++histograms[pass * RADIX_BUCKETS_COUNT + GetDigit(key, *current, pass)];
+        }
+    }
+    bool inBuffer = false;
+    for (int pass = 0; pass < RADIX_PASSES_COUNT; ++pass)
+    {
+        int *offsets = &histograms[pass * RADIX_BUCKETS_COUNT];
+        if (length == offsets[GetDigit(key, *begin, pass)])
             continue;
+        int offset = 0;
+        for (int bucket = 0; bucket < RADIX_BUCKETS_COUNT; ++bucket)
+        {
+            int count = offsets[bucket];
+            offsets[bucket] = offset;
+            offset += count;
+        }
+        if (inBuffer)
+            RadixScatter(buffer.begin(), buffer.begin() + length, begin, offsets, pass, key);
+        else
+            RadixScatter(begin, end, buffer.begin(), offsets, pass, key);
+        inBuffer = !inBuffer;
+    }
+    if (inBuffer)
+        std::move(buffer.begin(), buffer.begin() + length, begin);
+}
+
+const int OUTPUT_BUFFER_SIZE = 1 << 16;
+const int INPUT_READ_SIZE = 1 << 16;
+
+// Maps the input when it is a regular file and otherwise reads it through
+// a window of INPUT_READ_SIZE bytes, so a pipe costs no more memory than
+// the window; integers are parsed straight from memory
+class FastInput
+{
+    FILE *file_;
+    char *mapping_;
+    size_t mappingSize_;
+    std::vector<char> buffer_;
+    const char *position_;
+    const char *end_;
+
+    FastInput(const FastInput &);
+    FastInput &operator=(const FastInput &);
+
+    static bool IsDigit(char symbol)
+    {
+        return static_cast<unsigned char>(symbol - '0') < 10;
+    }
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // Every byte of the block is a digit
+    static bool AreEightDigits(unsigned long long block)
+    {
+        unsigned long long highNibbles = block & 0xF0F0F0F0F0F0F0F0ULL;
+        unsigned long long shiftedHighNibbles = 
+            (block + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL;
+        return 0x3333333333333333ULL == (highNibbles | (shiftedHighNibbles >> 4));
+    }
+
+    // Combines digits pairwise, then pairs of pairs, without a loop
+    static unsigned long long ParseEightDigits(unsigned long long block)
+    {
+        block -= 0x3030303030303030ULL;
+        block = block * 10 + (block >> 8);
+        return ((block & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)) +
+                ((block >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32))) >> 32;
+    }
+#endif
+
+    // Moves the unread bytes to the front of the window and reads more after
+    // them; false if nothing more could be read
+    bool Refill()
+    {
+        if (NULL == file_)
+            return false;
+        size_t unread = end_ - position_;
+        memmove(buffer_.data(), position_, unread);
+        size_t read = fread(buffer_.data() + unread, 1, buffer_.size() - unread, file_);
+        position_ = buffer_.data();
+        end_ = position_ + unread + read;
+        return read > 0;
+    }
+
+public:
+    explicit FastInput(FILE *file) : file_(NULL), mapping_(NULL), mappingSize_(0)
+    {
+        int descriptor = fileno(file);
+        struct stat fileStat;
+        off_t offset = lseek(descriptor, 0, SEEK_CUR);
+        if (0 == fstat(descriptor, &fileStat) && S_ISREG(fileStat.st_mode) && 
+            offset >= 0 && fileStat.st_size > offset)
+        {
+            void *mapping = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (MAP_FAILED != mapping)
+            {
+                mapping_ = static_cast<char *>(mapping);
+                mappingSize_ = fileStat.st_size;
+                madvise(mapping_, mappingSize_, MADV_SEQUENTIAL);
+                position_ = mapping_ + offset;
+                end_ = mapping_ + mappingSize_;
+                return;
+            }
         }
-        while (players[possiblePlayersLeft].GetEfficiency() +
-               players[possiblePlayersLeft + 1].GetEfficiency() <
-               players[possiblePlayersRight].GetEfficiency())
+        file_ = file;
+        buffer_.resize(INPUT_READ_SIZE);
+        position_ = buffer_.data();
+        end_ = position_;
+    }
+
+    ~FastInput()
+    {
+        if (NULL != mapping_)
+            munmap(mapping_, mappingSize_);
+    }
+
+    // Skips to the next integer and parses it; false at the end of the input
+    template <class Integer>
+    bool Read(Integer &value)
+    {
+        for (;;)
         {
-            possiblePlayersSum -= players[possiblePlayersLeft].GetEfficiency();
-            possiblePlayersLeft++;
+            while (position_ != end_ && '-' != *position_ && !IsDigit(*position_))
+                ++position_;
+            if (position_ != end_)
+                break;
+            if (!Refill())
+                return false;
         }
-        while (currentTeamEnd < possiblePlayersRight &&
-               OnePlayerEfficiencyLessOrEqualThenSumOthers(players[currentTeamEnd + 1],
-                                                           players[currentTeamBegin],
-                                                           players[currentTeamBegin + 1]))
+        bool negative = '-' == *position_;
+        if (negative)
+            ++position_;
+        unsigned long long result = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        unsigned long long block;
+        while (end_ - position_ >= 8 && 
+               (memcpy(&block, position_, 8), AreEightDigits(block)))
         {
-            currentTeamEnd++;
-            maxSumEffisiency += players[currentTeamEnd].GetEfficiency();
+            result = result * 100000000 + ParseEightDigits(block);
+            position_ += 8;
         }
-        if (possiblePlayersSum > maxSumEffisiency)
+#endif
+        do
         {
-            maxSumEffisiency = possiblePlayersSum;
-            currentTeamBegin = possiblePlayersLeft;
-            currentTeamEnd = possiblePlayersRight;
+            while (position_ != end_ && IsDigit(*position_))
+            {
+                result = result * 10 + (*position_ - '0');
+                ++position_;
+            }
+        } while (position_ == end_ && Refill());
+        value = negative ? 0 - result : result;
+        return true;
+    }
+};
+
+// Formats numbers into a fixed buffer and writes it out in large blocks
+class BufferedWriter
+{
+    FILE *output_;
+    std::vector<char> buffer_;
+    size_t filled_;
+
+    BufferedWriter(const BufferedWriter &);
+    BufferedWriter &operator=(const BufferedWriter &);
+
+public:
+    explicit BufferedWriter(FILE *output) 
+        : output_(output), buffer_(OUTPUT_BUFFER_SIZE), filled_(0)
+    {
+    }
+
+    ~BufferedWriter()
+    {
+        Flush();
+    }
+
+    void Flush()
+    {
+        if (filled_ > 0)
+        {
+            fwrite(buffer_.data(), 1, filled_, output_);
+            filled_ = 0;
         }
+        fflush(output_);
     }
-    for (int countTeam = currentTeamBegin; countTeam <= currentTeamEnd; ++countTeam)
+
+    void WriteChar(char symbol)
     {
-        team.push_back(players[countTeam]);
+        if (filled_ == buffer_.size())
+            Flush();
+        buffer_[filled_++] = symbol;
     }
-    return team;
-}
 
-long ComputeTeamEfficiency(std::vector<SoccerPlayer> team)
+    void WriteNumber(long long number)
+    {
+        char digits[24];
+        int digitsCount = 0;
+        unsigned long long absoluteValue = number < 0 ? 
+            0ULL - static_cast<unsigned long long>(number) : number;
+        do
+        {
+            digits[digitsCount++] = '0' + absoluteValue % 10;
+            absoluteValue /= 10;
+        } while (absoluteValue > 0);
+        if (filled_ + digitsCount + 1 > buffer_.size())
+            Flush();
+        if (number < 0)
+            buffer_[filled_++] = '-';
+        while (digitsCount > 0)
+            buffer_[filled_++] = digits[--digitsCount];
+    }
+};
+
+std::vector<SoccerPlayer> ReadSoccerPlayers(FastInput &input)
 {
-    long sumEfficiency = 0;
-    int teamSize = team.size();
-    for (int countTeam = 0; 
-         countTeam < teamSize; ++countTeam )
+    std::vector<SoccerPlayer> players;
+    int playersCount = 0;
+    input.Read(playersCount);
+    players.reserve(playersCount);
+    for (int cnt = 0; cnt < playersCount; ++cnt)
     {
-        sumEfficiency += team[countTeam].GetEfficiency();
+		long efficiency = 0;
+        input.Read(efficiency);
+		SoccerPlayer soccerPlayer;
+        soccerPlayer.SetEfficiency(efficiency);
+        soccerPlayer.SetId(players.size());
+        players.push_back(soccerPlayer);
     }
-    return sumEfficiency;
+    return players;
 }
 
-// Prints effective team
-void PrintSoccerTeam(std::vector<SoccerPlayer> team)
+PlayerTable ReadPlayerTable(FastInput &input)
 {
-    CompareById compareById;
-    MergeSort<std::vector<SoccerPlayer>::iterator, SoccerPlayer, CompareById>
-        (team.begin(), team.end(), compareById);
-    int teamSize = team.size();
-    cout << ComputeTeamEfficiency(team) << endl;
-    for (int countTeam = 0 ; countTeam < teamSize; ++countTeam)
+    PlayerTable players;
+    int playersCount = 0;
+    input.Read(playersCount);
+    players.Reserve(playersCount);
+    for (int cnt = 0; cnt < playersCount; ++cnt)
     {
-        cout << team[countTeam].GetId() + 1 << " ";
+        long efficiency = 0;
+        input.Read(efficiency);
+        players.Add(efficiency);
     }
-    cout << endl;
+    return players;
 }
 
-int main()
+bool OnePlayerEfficiencyLessOrEqualThenSumOthers(long onePlayer,
+                                                 long firstAnotherPlayer,
+                                                 long secondAnotherPlayer)
 {
-    std::vector<SoccerPlayer> players = ReadSoccerPlayers();
-    std::vector<SoccerPlayer> team = BuildSoccerTeam(players);
-    PrintSoccerTeam(team);
+    return onePlayer <= static_cast<EfficiencySum>(firstAnotherPlayer) + secondAnotherPlayer;
+}
+
+#if defined(__x86_64__)
+// Adds four lanes at a time; false if any lane overflowed, which is
+// detected by a sign change that neither operand had
+__attribute__((target("avx2")))
+bool SumEfficienciesAvx2(const long *begin, const long *end, EfficiencySum &sum)
+{
+    __m256i sums = _mm256_setzero_si256();
+    __m256i overflows = _mm256_setzero_si256();
+    const long *current = begin;
+    for (; end - current >= 4; current += 4)
+    {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(current));
+        __m256i nextSums = _mm256_add_epi64(sums, values);
+        overflows = _mm256_or_si256(overflows, 
+            _mm256_and_si256(_mm256_xor_si256(sums, nextSums), 
+                             _mm256_xor_si256(values, nextSums)));
+        sums = nextSums;
+    }
+    if (0 != _mm256_movemask_pd(_mm256_castsi256_pd(overflows)))
+        return false;
+    long lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), sums);
+    sum = static_cast<EfficiencySum>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    for (; current != end; ++current)
+        sum += *current;
+    return true;
+}
+#endif
+
+EfficiencySum SumEfficiencies(const long *begin, const long *end)
+{
+    EfficiencySum sum = 0;
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("avx2") && SumEfficienciesAvx2(begin, end, sum))
+        return sum;
+    sum = 0;
+#endif
+    for (const long *current = begin; current != end; ++current)
+        sum += *current;
+    return sum;
+}
+
+// Sorts the rows of the table by efficiency, stably
+void SortByEfficiency(PlayerTable &players, 
+                      int threadsCount)
+{
+    int playersCount = players.GetSize();
+    std::vector<int> order(playersCount);
+    for (int row = 0; row < playersCount; ++row)
+        order[row] = row;
+    if (1 == threadsCount)
+    {
+        std::vector<int> buffer;
+        RadixSort<std::vector<int>::iterator, int, RowEfficiencyKey>
+            (order.begin(), order.end(), buffer, RowEfficiencyKey(players));
+    }
+    else
+    {
+        ParallelMergeSort<std::vector<int>::iterator, int, CompareRowsByEfficiency>
+            (order.begin(), 
+             order.end(),
+             CompareRowsByEfficiency(players),
+             threadsCount);
+    }
+    players.Permute(order);
+}
+
+// Sorts the table by efficiency and returns the rows of the team; the team
+// of an empty table is empty
+RowRange BuildSoccerTeam(PlayerTable &players, 
+                         int threadsCount)
+{
+    SortByEfficiency(players, threadsCount);
+    int playersCount = players.GetSize();
+    if (0 == playersCount)
+    {
+        RowRange emptyTeam = { 0, 0 };
+        return emptyTeam;
+    }
+    int currentTeamBegin = 0;
+    int possiblePlayersRight = 0;
+    int possiblePlayersLeft = 0;
+    int currentTeamEnd = 0;
+    EfficiencySum possiblePlayersSum = players.GetEfficiency(0);
+    EfficiencySum maxSumEffisiency = players.GetEfficiency(0);
+    while (playersCount - 1 != possiblePlayersRight)
+    {
+        possiblePlayersRight++;
+        possiblePlayersSum += players.GetEfficiency(possiblePlayersRight);
+        if (possiblePlayersRight - currentTeamBegin < 2)
+        {
+            maxSumEffisiency += players.GetEfficiency(possiblePlayersRight);
+            currentTeamEnd = possiblePlayersRight;
+            possiblePlayersLeft = currentTeamBegin;
+            continue;
+        }
+        while (!OnePlayerEfficiencyLessOrEqualThenSumOthers(
+                   players.GetEfficiency(possiblePlayersRight),
+                   players.GetEfficiency(possiblePlayersLeft),
+                   players.GetEfficiency(possiblePlayersLeft + 1)))
+        {
+            possiblePlayersSum -= players.GetEfficiency(possiblePlayersLeft);
+            possiblePlayersLeft++;
+        }
+        while (currentTeamEnd < possiblePlayersRight &&
+               OnePlayerEfficiencyLessOrEqualThenSumOthers(
+                   players.GetEfficiency(currentTeamEnd + 1),
+                   players.GetEfficiency(currentTeamBegin),
+                   players.GetEfficiency(currentTeamBegin + 1)))
+        {
+            currentTeamEnd++;
+            maxSumEffisiency += players.GetEfficiency(currentTeamEnd);
+        }
+        if (possiblePlayersSum > maxSumEffisiency)
+        {
+            maxSumEffisiency = possiblePlayersSum;
+            currentTeamBegin = possiblePlayersLeft;
+            currentTeamEnd = possiblePlayersRight;
+        }
+    }
+    ToEfficiency(maxSumEffisiency);
+    RowRange team = { currentTeamBegin, currentTeamEnd + 1 };
+    return team;
+}
+
+long ComputeTeamEfficiency(const PlayerTable &players, RowRange team)
+{
+    return ToEfficiency(SumEfficiencies(players.GetEfficiencies() + team.first, 
+                                        players.GetEfficiencies() + team.last));
+}
+
+// Prints effective team; ids are listed in increasing order by marking
+// them first, so the team itself is never copied or sorted
+void PrintSoccerTeam(const PlayerTable &players, RowRange team, BufferedWriter &writer)
+{
+    std::vector<bool> inTeam(players.GetSize(), false);
+    for (int row = team.first; row < team.last; ++row)
+    {
+        inTeam[players.GetId(row)] = true;
+    }
+    writer.WriteNumber(ComputeTeamEfficiency(players, team));
+    writer.WriteChar('\n');
+    for (size_t id = 0; id < inTeam.size(); ++id)
+    {
+        if (inTeam[id])
+        {
+            writer.WriteNumber(id + 1);
+            writer.WriteChar(' ');
+        }
+    }
+    writer.WriteChar('\n');
+}
+
+const int NO_NODE = -1;
+// Pair sum of the strongest player, who has no next player; greater than
+// the sum of any two longs
+const EfficiencySum NO_PAIR = static_cast<EfficiencySum>(1) << 100;
+
+// Sums are kept in 128 bits, so no team overflows inside the treap
+struct TeamTreapNode
+{
+    long efficiency;
+    int id;
+    unsigned int priority;
+    int left;
+    int right;
+    int size;
+    EfficiencySum sum;
+    // Efficiency of this player plus the next one in sorted order
+    EfficiencySum pairSum;
+    EfficiencySum maxPairSum;
+    // Best team whose two weakest players are this one and the next one
+    EfficiencySum teamSum;
+    EfficiencySum maxTeamSum;
+    // Still to be added to teamSum in the subtrees of the children
+    EfficiencySum pendingAdd;
+};
+
+// Keeps players sorted by efficiency in a treap and maintains, for every
+// player l, the team of l, the next player and everyone up to their pair
+// sum. Inserting v only adds v to the teams of a range of players with a
+// pair sum of at least v and changes the two pairs around v, so updates
+// and the best team cost O(log n).
+class DynamicSoccerTeam
+{
+    std::vector<TeamTreapNode> nodes_;
+    std::vector<int> freeNodes_;
+    int root_;
+    std::mt19937 random_;
+
+    int Size(int node) const
+    {
+        return NO_NODE == node ? 0 : nodes_[node].size;
+    }
+
+    EfficiencySum Sum(int node) const
+    {
+        return NO_NODE == node ? 0 : nodes_[node].sum;
+    }
+
+    void AddToTeams(int node, EfficiencySum value)
+    {
+        if (NO_NODE == node)
+            return;
+        nodes_[node].teamSum += value;
+        nodes_[node].maxTeamSum += value;
+        nodes_[node].pendingAdd += value;
+    }
+
+    void Push(int node)
+    {
+        if (0 != nodes_[node].pendingAdd)
+        {
+            AddToTeams(nodes_[node].left, nodes_[node].pendingAdd);
+            AddToTeams(nodes_[node].right, nodes_[node].pendingAdd);
+            nodes_[node].pendingAdd = 0;
+        }
+    }
+
+    void Update(int node)
+    {
+        TeamTreapNode &current = nodes_[node];
+        current.size = 1 + Size(current.left) + Size(current.right);
+        current.sum = current.efficiency + Sum(current.left) + Sum(current.right);
+        current.maxPairSum = current.pairSum;
+        current.maxTeamSum = current.teamSum;
+        int children[] = { current.left, current.right };
+        for (int child = 0; child < 2; ++child)
+        {
+            if (NO_NODE != children[child])
+            {
+                current.maxPairSum = std::max(current.maxPairSum, nodes_[children[child]].maxPairSum);
+                current.maxTeamSum = std::max(current.maxTeamSum, nodes_[children[child]].maxTeamSum);
+            }
+        }
+    }
+
+    // Moves the first count players of the tree to left, the rest to right
+    void Split(int node, int count, int &left, int &right)
+    {
+        if (NO_NODE == node)
+        {
+            left = right = NO_NODE;
+            return;
+        }
+        Push(node);
+        if (Size(nodes_[node].left) < count)
+        {
+            Split(nodes_[node].right, count - Size(nodes_[node].left) - 1, 
+                  nodes_[node].right, right);
+            left = node;
+        }
+        else
+        {
+            Split(nodes_[node].left, count, left, nodes_[node].left);
+            right = node;
+        }
+        Update(node);
+    }
+
+    int Merge(int left, int right)
+    {
+        if (NO_NODE == left || NO_NODE == right)
+            return NO_NODE == left ? right : left;
+        if (nodes_[left].priority > nodes_[right].priority)
+        {
+            Push(left);
+            nodes_[left].right = Merge(nodes_[left].right, right);
+            Update(left);
+            return left;
+        }
+        Push(right);
+        nodes_[right].left = Merge(left, nodes_[right].left);
+        Update(right);
+        return right;
+    }
+
+    // Number of players ordered before the player
+    int CountLess(const SoccerPlayer &player) const
+    {
+        int count = 0;
+        for (int node = root_; NO_NODE != node;)
+        {
+            const TeamTreapNode &current = nodes_[node];
+            if (current.efficiency < player.GetEfficiency() ||
+                (current.efficiency == player.GetEfficiency() && current.id < player.GetId()))
+            {
+                count += Size(current.left) + 1;
+                node = current.right;
+            }
+            else
+            {
+                node = current.left;
+            }
+        }
+        return count;
+    }
+
+    int CountNotGreater(EfficiencySum efficiency) const
+    {
+        int count = 0;
+        for (int node = root_; NO_NODE != node;)
+        {
+            if (nodes_[node].efficiency <= efficiency)
+            {
+                count += Size(nodes_[node].left) + 1;
+                node = nodes_[node].right;
+            }
+            else
+            {
+                node = nodes_[node].left;
+            }
+        }
+        return count;
+    }
+
+    EfficiencySum PrefixSum(int count) const
+    {
+        EfficiencySum sum = 0;
+        for (int node = root_; NO_NODE != node && count > 0;)
+        {
+            if (Size(nodes_[node].left) < count)
+            {
+                sum += Sum(nodes_[node].left) + nodes_[node].efficiency;
+                count -= Size(nodes_[node].left) + 1;
+                node = nodes_[node].right;
+            }
+            else
+            {
+                node = nodes_[node].left;
+            }
+        }
+        return sum;
+    }
+
+    long GetEfficiency(int position) const
+    {
+        return nodes_[FindNode(position)].efficiency;
+    }
+
+    // Pair sums grow along the sorted order, so the first one that is not
+    // less than efficiency is found by one descent
+    int FirstPairNotLess(long efficiency) const
+    {
+        int position = 0;
+        for (int node = root_; NO_NODE != node;)
+        {
+            int left = nodes_[node].left;
+            if (NO_NODE != left && nodes_[left].maxPairSum >= efficiency)
+            {
+                node = left;
+            }
+            else if (nodes_[node].pairSum >= efficiency)
+            {
+                return position + Size(left);
+            }
+            else
+            {
+                position += Size(left) + 1;
+                node = nodes_[node].right;
+            }
+        }
+        return position;
+    }
+
+    // Adds value to the teams at positions [first, last] of the subtree
+    void AddToTeams(int node, int first, int last, EfficiencySum value)
+    {
+        if (NO_NODE == node || first > last || last < 0 || first >= Size(node))
+            return;
+        if (first <= 0 && Size(node) - 1 <= last)
+        {
+            AddToTeams(node, value);
+            return;
+        }
+        Push(node);
+        int leftSize = Size(nodes_[node].left);
+        AddToTeams(nodes_[node].left, first, last, value);
+        if (first <= leftSize && leftSize <= last)
+            nodes_[node].teamSum += value;
+        AddToTeams(nodes_[node].right, first - leftSize - 1, last - leftSize - 1, value);
+        Update(node);
+    }
+
+    void SetTeam(int node, int position, EfficiencySum pairSum, EfficiencySum teamSum)
+    {
+        Push(node);
+        int leftSize = Size(nodes_[node].left);
+        if (position < leftSize)
+        {
+            SetTeam(nodes_[node].left, position, pairSum, teamSum);
+        }
+        else if (position > leftSize)
+        {
+            SetTeam(nodes_[node].right, position - leftSize - 1, pairSum, teamSum);
+        }
+        else
+        {
+            nodes_[node].pairSum = pairSum;
+            nodes_[node].teamSum = teamSum;
+        }
+        Update(node);
+    }
+
+    // Recomputes the pair and the team of the player at position
+    void RecomputeTeam(int position)
+    {
+        if (position < 0 || position >= Size(root_))
+            return;
+        EfficiencySum pairSum = NO_PAIR;
+        EfficiencySum teamSum = GetEfficiency(position);
+        if (position + 1 < Size(root_))
+        {
+            pairSum = teamSum + GetEfficiency(position + 1);
+            teamSum = PrefixSum(CountNotGreater(pairSum)) - PrefixSum(position);
+        }
+        SetTeam(root_, position, pairSum, teamSum);
+    }
+
+    // Places the new node at position; only the subtree it lands on top of is split
+    int InsertNode(int node, int newNode, int position)
+    {
+        if (NO_NODE == node)
+            return newNode;
+        if (nodes_[newNode].priority > nodes_[node].priority)
+        {
+            Split(node, position, nodes_[newNode].left, nodes_[newNode].right);
+            Update(newNode);
+            return newNode;
+        }
+        Push(node);
+        int leftSize = Size(nodes_[node].left);
+        if (position <= leftSize)
+            nodes_[node].left = InsertNode(nodes_[node].left, newNode, position);
+        else
+            nodes_[node].right = InsertNode(nodes_[node].right, newNode, position - leftSize - 1);
+        Update(node);
+        return node;
+    }
+
+    int EraseNode(int node, int position)
+    {
+        Push(node);
+        int leftSize = Size(nodes_[node].left);
+        if (position == leftSize)
+        {
+            freeNodes_.push_back(node);
+            return Merge(nodes_[node].left, nodes_[node].right);
+        }
+        if (position < leftSize)
+            nodes_[node].left = EraseNode(nodes_[node].left, position);
+        else
+            nodes_[node].right = EraseNode(nodes_[node].right, position - leftSize - 1);
+        Update(node);
+        return node;
+    }
+
+    int FindNode(int position) const
+    {
+        int node = root_;
+        while (Size(nodes_[node].left) != position)
+        {
+            if (Size(nodes_[node].left) < position)
+            {
+                position -= Size(nodes_[node].left) + 1;
+                node = nodes_[node].right;
+            }
+            else
+            {
+                node = nodes_[node].left;
+            }
+        }
+        return node;
+    }
+
+public:
+    DynamicSoccerTeam() : root_(NO_NODE), random_(0)
+    {
+    }
+
+    // Replaces the players; builds the treap from the sorted order in O(n)
+    // after sorting
+    void Build(std::vector<SoccerPlayer> players)
+    {
+        std::vector<SoccerPlayer> buffer;
+        RadixSort<std::vector<SoccerPlayer>::iterator, SoccerPlayer, EfficiencyKey>
+            (players.begin(), players.end(), buffer, EfficiencyKey());
+        int playersCount = players.size();
+        std::vector<EfficiencySum> prefixSums(playersCount + 1, 0);
+        for (int position = 0; position < playersCount; ++position)
+            prefixSums[position + 1] = prefixSums[position] + players[position].GetEfficiency();
+        nodes_.assign(playersCount, TeamTreapNode());
+        freeNodes_.clear();
+        std::vector<int> rightSpine;
+        int teamEnd = 0;
+        for (int position = 0; position < playersCount; ++position)
+        {
+            TeamTreapNode &node = nodes_[position];
+            node.efficiency = players[position].GetEfficiency();
+            node.id = players[position].GetId();
+            node.priority = static_cast<unsigned int>(random_());
+            node.left = node.right = NO_NODE;
+            node.pendingAdd = 0;
+            node.pairSum = NO_PAIR;
+            node.teamSum = node.efficiency;
+            if (position + 1 < playersCount)
+            {
+                node.pairSum = static_cast<EfficiencySum>(node.efficiency) + 
+                               players[position + 1].GetEfficiency();
+                teamEnd = std::max(teamEnd, position + 1);
+                while (teamEnd + 1 < playersCount && 
+                       players[teamEnd + 1].GetEfficiency() <= node.pairSum)
+                {
+                    ++teamEnd;
+                }
+                node.teamSum = prefixSums[teamEnd + 1] - prefixSums[position];
+            }
+            // Cartesian tree by priority: the new node takes over the part of
+            // the right spine with lower priorities as its left subtree
+            int lastPopped = NO_NODE;
+            while (!rightSpine.empty() && nodes_[rightSpine.back()].priority < node.priority)
+            {
+                lastPopped = rightSpine.back();
+                rightSpine.pop_back();
+                Update(lastPopped);
+            }
+            node.left = lastPopped;
+            if (!rightSpine.empty())
+                nodes_[rightSpine.back()].right = position;
+            rightSpine.push_back(position);
+        }
+        root_ = rightSpine.empty() ? NO_NODE : rightSpine.front();
+        while (!rightSpine.empty())
+        {
+            Update(rightSpine.back());
+            rightSpine.pop_back();
+        }
+    }
+
+    int GetPlayersCount() const
+    {
+        return Size(root_);
+    }
+
+    // Efficiency of the best team, 0 when there are no players; throws
+    // std::overflow_error if it does not fit in a long
+    long GetBestTeamEfficiency() const
+    {
+        return NO_NODE == root_ ? 0 : ToEfficiency(nodes_[root_].maxTeamSum);
+    }
+
+    void Insert(const SoccerPlayer &player)
+    {
+        int position = CountLess(player);
+        AddToTeams(root_, FirstPairNotLess(player.GetEfficiency()), position - 2, 
+                   player.GetEfficiency());
+        TeamTreapNode node = { player.GetEfficiency(), player.GetId(), 
+                               static_cast<unsigned int>(random_()), 
+                               NO_NODE, NO_NODE, 1, player.GetEfficiency(), 
+                               NO_PAIR, NO_PAIR, 0, 0, 0 };
+        int index;
+        if (freeNodes_.empty())
+        {
+            index = nodes_.size();
+            nodes_.push_back(node);
+        }
+        else
+        {
+            index = freeNodes_.back();
+            freeNodes_.pop_back();
+            nodes_[index] = node;
+        }
+        root_ = InsertNode(root_, index, position);
+        RecomputeTeam(position - 1);
+        RecomputeTeam(position);
+    }
+
+    // The player must have been inserted with the same efficiency and id
+    void Remove(const SoccerPlayer &player)
+    {
+        int position = CountLess(player);
+        if (position >= Size(root_) || nodes_[FindNode(position)].id != player.GetId() ||
+            nodes_[FindNode(position)].efficiency != player.GetEfficiency())
+        {
+            throw std::invalid_argument("no such player");
+        }
+        root_ = EraseNode(root_, position);
+        AddToTeams(root_, FirstPairNotLess(player.GetEfficiency()), position - 2, 
+                   -player.GetEfficiency());
+        RecomputeTeam(position - 1);
+    }
+};
+
+// Reads updates as pairs of a player number and a new efficiency and prints
+// the efficiency of the best team after each of them
+void MaintainSoccerTeam(FastInput &input, BufferedWriter &writer)
+{
+    std::vector<SoccerPlayer> players = ReadSoccerPlayers(input);
+    DynamicSoccerTeam team;
+    team.Build(players);
+    int updatesCount = 0;
+    input.Read(updatesCount);
+    for (int update = 0; update < updatesCount; ++update)
+    {
+        int playerNumber = 0;
+        long efficiency = 0;
+        input.Read(playerNumber);
+        input.Read(efficiency);
+        SoccerPlayer &player = players[playerNumber - 1];
+        team.Remove(player);
+        player.SetEfficiency(efficiency);
+        team.Insert(player);
+        writer.WriteNumber(team.GetBestTeamEfficiency());
+        writer.WriteChar('\n');
+    }
+}
+
+// Efficiencies of the players a query may use, both ends included
+struct EfficiencyRange
+{
+    long low;
+    long high;
+};
+
+// Answers "best team of the players with efficiency in [low, high]". Those
+// players are a range of rows of the sorted table. The team starting at
+// row l can take every player up to teamEnds_[l], and these ends never
+// decrease. So in the rows [first, last) the teams of the rows before some
+// cut are kept whole and their best comes from a sparse table. Every team
+// after the cut is clipped at last, and the first of them is the best.
+class TeamQueryEngine
+{
+    std::vector<long> efficiencies_;
+    std::vector<EfficiencySum> prefixSums_;
+    // One past the last player of the team starting at each row
+    std::vector<int> teamEnds_;
+    // Level k holds the best team among the rows [row, row + 2^k)
+    std::vector<std::vector<EfficiencySum> > maxTeamSums_;
+
+    static int FloorLog2(int value)
+    {
+        return 31 - __builtin_clz(value);
+    }
+
+    EfficiencySum GetMaxTeamSum(int first, int last) const
+    {
+        int level = FloorLog2(last - first);
+        return std::max(maxTeamSums_[level][first], 
+                        maxTeamSums_[level][last - (1 << level)]);
+    }
+
+public:
+    // The table must be sorted by efficiency
+    void Init(const PlayerTable &sortedPlayers)
+    {
+        int playersCount = sortedPlayers.GetSize();
+        efficiencies_.resize(playersCount);
+        prefixSums_.assign(playersCount + 1, 0);
+        for (int row = 0; row < playersCount; ++row)
+        {
+            efficiencies_[row] = sortedPlayers.GetEfficiency(row);
+            prefixSums_[row + 1] = prefixSums_[row] + efficiencies_[row];
+        }
+        teamEnds_.resize(playersCount);
+        maxTeamSums_.assign(1, std::vector<EfficiencySum>(playersCount));
+        int teamEnd = 0;
+        for (int row = 0; row < playersCount; ++row)
+        {
+            teamEnd = std::max(teamEnd, std::min(row + 2, playersCount));
+            while (teamEnd < playersCount && row + 1 < playersCount &&
+                   OnePlayerEfficiencyLessOrEqualThenSumOthers(efficiencies_[teamEnd], 
+                                                               efficiencies_[row], 
+                                                               efficiencies_[row + 1]))
+            {
+                ++teamEnd;
+            }
+            teamEnds_[row] = teamEnd;
+            maxTeamSums_[0][row] = prefixSums_[teamEnd] - prefixSums_[row];
+        }
+        for (int level = 1; (1 << level) <= playersCount; ++level)
+        {
+            const std::vector<EfficiencySum> &previous = maxTeamSums_[level - 1];
+            std::vector<EfficiencySum> current(playersCount - (1 << level) + 1);
+            for (size_t row = 0; row < current.size(); ++row)
+                current[row] = std::max(previous[row], previous[row + (1 << (level - 1))]);
+            maxTeamSums_.push_back(std::vector<EfficiencySum>());
+            maxTeamSums_.back().swap(current);
+        }
+    }
+
+    // Efficiency of the best team, 0 when no player fits the range; throws
+    // std::overflow_error if it does not fit in a long
+    long GetBestTeamEfficiency(EfficiencyRange range) const
+    {
+        int first = std::lower_bound(efficiencies_.begin(), efficiencies_.end(), range.low) - 
+                    efficiencies_.begin();
+        int last = std::upper_bound(efficiencies_.begin(), efficiencies_.end(), range.high) - 
+                   efficiencies_.begin();
+        if (first >= last)
+            return 0;
+        int cut = std::upper_bound(teamEnds_.begin() + first, teamEnds_.begin() + last, last) - 
+                  teamEnds_.begin();
+        EfficiencySum best = 0;
+        if (first < cut)
+            best = GetMaxTeamSum(first, cut);
+        if (cut < last)
+            best = std::max(best, prefixSums_[last] - prefixSums_[cut]);
+        return ToEfficiency(best);
+    }
+
+    std::vector<long> GetBestTeamEfficiencies(const std::vector<EfficiencyRange> &ranges) const
+    {
+        std::vector<long> answers(ranges.size());
+        for (size_t query = 0; query < ranges.size(); ++query)
+            answers[query] = GetBestTeamEfficiency(ranges[query]);
+        return answers;
+    }
+};
+
+// Efficiency of the best team among the players with ids below each count.
+// The queries are answered in increasing order of count while players join
+// a DynamicSoccerTeam in id order.
+std::vector<long> GetBestTeamEfficienciesOfFirstPlayers(const PlayerTable &players, 
+                                                        const std::vector<int> &counts)
+{
+    std::vector<long> efficiencies(players.GetSize());
+    for (int row = 0; row < players.GetSize(); ++row)
+        efficiencies[players.GetId(row)] = players.GetEfficiency(row);
+    std::vector<int> order(counts.size());
+    for (size_t query = 0; query < counts.size(); ++query)
+        order[query] = query;
+    std::stable_sort(order.begin(), order.end(), CompareByCount(counts));
+    std::vector<long> answers(counts.size());
+    DynamicSoccerTeam team;
+    int joined = 0;
+    for (size_t query = 0; query < order.size(); ++query)
+    {
+        int count = std::min(counts[order[query]], players.GetSize());
+        for (; joined < count; ++joined)
+        {
+            SoccerPlayer player;
+            player.SetId(joined);
+            player.SetEfficiency(efficiencies[joined]);
+            team.Insert(player);
+        }
+        answers[order[query]] = team.GetBestTeamEfficiency();
+    }
+    return answers;
+}
+
+const int EFFICIENCY_RANGE_QUERY = 1;
+const int FIRST_PLAYERS_QUERY = 2;
+
+// Reads the number of queries and the queries after the players: "1 low
+// high" for an efficiency range and "2 count" for the first count players.
+// Prints the efficiency of the best team for each query.
+void AnswerTeamQueries(FastInput &input, BufferedWriter &writer)
+{
+    PlayerTable players = ReadPlayerTable(input);
+    int queriesCount = 0;
+    input.Read(queriesCount);
+    std::vector<int> types(queriesCount);
+    std::vector<EfficiencyRange> ranges;
+    std::vector<int> counts;
+    for (int query = 0; query < queriesCount; ++query)
+    {
+        input.Read(types[query]);
+        if (EFFICIENCY_RANGE_QUERY == types[query])
+        {
+            EfficiencyRange range = { 0, 0 };
+            input.Read(range.low);
+            input.Read(range.high);
+            ranges.push_back(range);
+        }
+        else
+        {
+            int count = 0;
+            input.Read(count);
+            counts.push_back(count);
+        }
+    }
+    std::vector<long> firstPlayersAnswers = GetBestTeamEfficienciesOfFirstPlayers(players, counts);
+    SortByEfficiency(players, 1);
+    TeamQueryEngine engine;
+    engine.Init(players);
+    std::vector<long> rangeAnswers = engine.GetBestTeamEfficiencies(ranges);
+    int rangeQuery = 0;
+    int firstPlayersQuery = 0;
+    for (int query = 0; query < queriesCount; ++query)
+    {
+        if (EFFICIENCY_RANGE_QUERY == types[query])
+            writer.WriteNumber(rangeAnswers[rangeQuery++]);
+        else
+            writer.WriteNumber(firstPlayersAnswers[firstPlayersQuery++]);
+        writer.WriteChar('\n');
+    }
+}
+
+// Records per run sorted in memory, per file buffer, and per merge
+const int EXTERNAL_RUN_SIZE = 1 << 20;
+const int EXTERNAL_BUFFER_SIZE = 1 << 12;
+const int EXTERNAL_MAX_MERGE_WAYS = 256;
+
+// A sorted sequence of records stored in a temporary file
+struct Run
+{
+    FILE *file;
+    long long length;
+};
+
+FILE *CreateTemporaryFile()
+{
+    FILE *file = tmpfile();
+    if (NULL == file)
+        throw std::runtime_error("can not create a temporary file");
+    return file;
+}
+
+template <class T>
+class RecordWriter
+{
+    FILE *file_;
+    std::vector<T> buffer_;
+    long long writtenCount_;
+
+public:
+    explicit RecordWriter(FILE *file) : file_(file), writtenCount_(0)
+    {
+        buffer_.reserve(EXTERNAL_BUFFER_SIZE);
+    }
+
+    void Write(const T &record)
+    {
+        buffer_.push_back(record);
+        if (EXTERNAL_BUFFER_SIZE == buffer_.size())
+            Flush();
+    }
+
+    void Flush()
+    {
+        if (buffer_.size() != fwrite(buffer_.data(), sizeof(T), buffer_.size(), file_) ||
+            0 != fflush(file_))
+        {
+            throw std::runtime_error("can not write a temporary file");
+        }
+        writtenCount_ += buffer_.size();
+        buffer_.clear();
+    }
+
+    long long GetWrittenCount() const
+    {
+        return writtenCount_;
+    }
+};
+
+// Reads count records starting at first. Every reader keeps its own offset,
+// so several of them can walk one file.
+template <class T>
+class RecordReader
+{
+    FILE *file_;
+    long long position_;
+    long long end_;
+    std::vector<T> buffer_;
+    int current_;
+    int loaded_;
+
+    void Load()
+    {
+        loaded_ = std::min<long long>(end_ - position_, EXTERNAL_BUFFER_SIZE);
+        current_ = 0;
+        if (0 == loaded_)
+            return;
+        size_t bytes = loaded_ * sizeof(T);
+        if (static_cast<ssize_t>(bytes) != 
+            pread(fileno(file_), buffer_.data(), bytes, position_ * sizeof(T)))
+        {
+            throw std::runtime_error("can not read a temporary file");
+        }
+        position_ += loaded_;
+    }
+
+public:
+    RecordReader(FILE *file, long long first, long long count)
+        : file_(file), position_(first), end_(first + count), 
+          buffer_(EXTERNAL_BUFFER_SIZE), current_(0), loaded_(0)
+    {
+        Load();
+    }
+
+    bool HasCurrent() const
+    {
+        return current_ < loaded_;
+    }
+
+    const T &Current() const
+    {
+        return buffer_[current_];
+    }
+
+    void Advance()
+    {
+        if (++current_ == loaded_)
+            Load();
+    }
+};
+
+// Tournament tree over the readers: every inner node keeps the loser of its
+// match, so taking the smallest record replays only one leaf-to-root path.
+// Equal records come from the reader with the lower index first.
+template <class T, class Compare>
+class LoserTree
+{
+    std::vector<RecordReader<T> > &readers_;
+    Compare compare_;
+    std::vector<int> losers_;
+    int winner_;
+
+    bool Beats(int first, int second) const
+    {
+        if (!readers_[first].HasCurrent() || !readers_[second].HasCurrent())
+        {
+            return readers_[first].HasCurrent() || 
+                   (!readers_[second].HasCurrent() && first < second);
+        }
+        if (compare_(readers_[second].Current(), readers_[first].Current()))
+            return false;
+        return compare_(readers_[first].Current(), readers_[second].Current()) || 
+               first < second;
+    }
+
+public:
+    LoserTree(std::vector<RecordReader<T> > &readers, Compare compare)
+        : readers_(readers), compare_(compare), losers_(readers.size()), winner_(0)
+    {
+        int leavesCount = readers_.size();
+        std::vector<int> winners(2 * leavesCount);
+        for (int leaf = 0; leaf < leavesCount; ++leaf)
+            winners[leavesCount + leaf] = leaf;
+        for (int node = leavesCount - 1; node >= 1; --node)
+        {
+            int first = winners[2 * node];
+            int second = winners[2 * node + 1];
+            winners[node] = Beats(first, second) ? first : second;
+            losers_[node] = Beats(first, second) ? second : first;
+        }
+        if (leavesCount > 1)
+            winner_ = winners[1];
+    }
+
+    bool Empty() const
+    {
+        return !readers_[winner_].HasCurrent();
+    }
+
+    const T &Top() const
+    {
+        return readers_[winner_].Current();
+    }
+
+    void Pop()
+    {
+        readers_[winner_].Advance();
+        for (int node = (winner_ + readers_.size()) / 2; node >= 1; node /= 2)
+        {
+            if (Beats(losers_[node], winner_))
+                std::swap(losers_[node], winner_);
+        }
+    }
+};
+
+// Merges the runs into output and closes their files
+template <class T, class Compare, class Output>
+void MergeRuns(const std::vector<Run> &runs, 
+               Compare compare, 
+               Output &output)
+{
+    std::vector<RecordReader<T> > readers;
+    readers.reserve(runs.size());
+    for (size_t run = 0; run < runs.size(); ++run)
+        readers.push_back(RecordReader<T>(runs[run].file, 0, runs[run].length));
+    if (!readers.empty())
+    {
+        LoserTree<T, Compare> tree(readers, compare);
+        for (; !tree.Empty(); tree.Pop())
+            output.Write(tree.Top());
+    }
+    for (size_t run = 0; run < runs.size(); ++run)
+        fclose(runs[run].file);
+}
+
+// Merges neighbouring runs until one merge can take all of them; neighbours
+// keep the merge stable
+template <class T, class Compare>
+std::vector<Run> ReduceRuns(std::vector<Run> runs, 
+                            Compare compare)
+{
+    while (runs.size() > EXTERNAL_MAX_MERGE_WAYS)
+    {
+        std::vector<Run> mergedRuns;
+        for (size_t first = 0; first < runs.size(); first += EXTERNAL_MAX_MERGE_WAYS)
+        {
+            size_t last = std::min<size_t>(first + EXTERNAL_MAX_MERGE_WAYS, runs.size());
+            Run merged = { CreateTemporaryFile(), 0 };
+            RecordWriter<T> writer(merged.file);
+            MergeRuns<T>(std::vector<Run>(runs.begin() + first, runs.begin() + last), 
+                         compare, writer);
+            writer.Flush();
+            merged.length = writer.GetWrittenCount();
+            mergedRuns.push_back(merged);
+        }
+        runs.swap(mergedRuns);
+    }
+    return runs;
+}
+
+// Cuts the added records into runs sorted by key in memory
+template <class T, class KeyExtractor>
+class RunsBuilder
+{
+    std::vector<T> run_;
+    std::vector<T> buffer_;
+    std::vector<Run> runs_;
+
+    void WriteRun()
+    {
+        RadixSort<typename std::vector<T>::iterator, T, KeyExtractor>
+            (run_.begin(), run_.end(), buffer_, KeyExtractor());
+        Run run = { CreateTemporaryFile(), static_cast<long long>(run_.size()) };
+        runs_.push_back(run);
+        if (run_.size() != fwrite(run_.data(), sizeof(T), run_.size(), run.file) || 
+            0 != fflush(run.file))
+        {
+            throw std::runtime_error("can not write a temporary file");
+        }
+        run_.clear();
+    }
+
+public:
+    void Add(const T &record)
+    {
+        if (run_.empty())
+            run_.reserve(EXTERNAL_RUN_SIZE);
+        run_.push_back(record);
+        if (EXTERNAL_RUN_SIZE == run_.size())
+            WriteRun();
+    }
+
+    std::vector<Run> Finish()
+    {
+        if (!run_.empty())
+            WriteRun();
+        std::vector<Run> runs;
+        runs.swap(runs_);
+        return runs;
+    }
+};
+
+// Positions of the team in the file of players sorted by efficiency
+struct ExternalTeam
+{
+    long long first;
+    long long count;
+    EfficiencySum sumEfficiency;
+};
+
+// For every right end the best team starts at the first player that, with
+// the next one, still outweighs it. That start only moves forward, so two
+// sequential cursors over the sorted file find the best team.
+ExternalTeam BuildSoccerTeamExternally(FILE *sortedPlayers, long long playersCount)
+{
+    ExternalTeam team = { 0, 0, 0 };
+    RecordReader<SoccerPlayer> right(sortedPlayers, 0, playersCount);
+    RecordReader<SoccerPlayer> nextToLeft(sortedPlayers, 0, playersCount);
+    SoccerPlayer left = nextToLeft.Current();
+    nextToLeft.Advance();
+    long long leftPosition = 0;
+    EfficiencySum sumEfficiency = 0;
+    for (long long rightPosition = 0; rightPosition < playersCount; ++rightPosition)
+    {
+        SoccerPlayer current = right.Current();
+        right.Advance();
+        sumEfficiency += current.GetEfficiency();
+        while (rightPosition - leftPosition >= 2 &&
+               !OnePlayerEfficiencyLessOrEqualThenSumOthers(
+                   current.GetEfficiency(), left.GetEfficiency(), 
+                   nextToLeft.Current().GetEfficiency()))
+        {
+            sumEfficiency -= left.GetEfficiency();
+            left = nextToLeft.Current();
+            nextToLeft.Advance();
+            ++leftPosition;
+        }
+        if (0 == rightPosition || sumEfficiency > team.sumEfficiency)
+        {
+            team.first = leftPosition;
+            team.count = rightPosition - leftPosition + 1;
+            team.sumEfficiency = sumEfficiency;
+        }
+    }
+    return team;
+}
+
+class IdPrinter
+{
+    BufferedWriter &writer_;
+
+public:
+    explicit IdPrinter(BufferedWriter &writer) : writer_(writer)
+    {
+    }
+
+    void Write(const SoccerPlayer &player)
+    {
+        writer_.WriteNumber(player.GetId() + 1);
+        writer_.WriteChar(' ');
+    }
+};
+
+// Builds and prints the team keeping at most a run of players in memory
+void BuildAndPrintSoccerTeamExternally(FastInput &input, BufferedWriter &output)
+{
+    long long playersCount = 0;
+    input.Read(playersCount);
+    RunsBuilder<SoccerPlayer, EfficiencyKey> playersRuns;
+    for (long long cnt = 0; cnt < playersCount; ++cnt)
+    {
+        long efficiency = 0;
+        input.Read(efficiency);
+        SoccerPlayer soccerPlayer;
+        soccerPlayer.SetEfficiency(efficiency);
+        soccerPlayer.SetId(cnt);
+        playersRuns.Add(soccerPlayer);
+    }
+    CompareByEfficiency compareByEfficiency;
+    std::vector<Run> runs = ReduceRuns<SoccerPlayer>(playersRuns.Finish(), compareByEfficiency);
+    FILE *sortedPlayers = CreateTemporaryFile();
+    RecordWriter<SoccerPlayer> writer(sortedPlayers);
+    MergeRuns<SoccerPlayer>(runs, compareByEfficiency, writer);
+    writer.Flush();
+
+    ExternalTeam team = BuildSoccerTeamExternally(sortedPlayers, playersCount);
+    RunsBuilder<SoccerPlayer, IdKey> teamRuns;
+    RecordReader<SoccerPlayer> teamReader(sortedPlayers, team.first, team.count);
+    for (; teamReader.HasCurrent(); teamReader.Advance())
+        teamRuns.Add(teamReader.Current());
+    fclose(sortedPlayers);
+
+    CompareById compareById;
+    output.WriteNumber(ToEfficiency(team.sumEfficiency));
+    output.WriteChar('\n');
+    IdPrinter printer(output);
+    MergeRuns<SoccerPlayer>(ReduceRuns<SoccerPlayer>(teamRuns.Finish(), compareById), 
+                            compareById, printer);
+    output.WriteChar('\n');
+}
+
+// Allocator of the benchmarked containers; all its copies, rebound ones
+// included, count their allocations in one counter
+template <class T>
+class CountingAllocator
+{
+    template <class U> friend class CountingAllocator;
+
+    long long *allocationsCount_;
+
+public:
+    typedef T value_type;
+
+    explicit CountingAllocator(long long &allocationsCount) 
+        : allocationsCount_(&allocationsCount)
+    {
+    }
+
+    template <class U>
+    CountingAllocator(const CountingAllocator<U> &other) 
+        : allocationsCount_(other.allocationsCount_)
+    {
+    }
+
+    T *allocate(size_t count)
+    {
+        ++*allocationsCount_;
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T *memory, size_t count)
+    {
+        std::allocator<T>().deallocate(memory, count);
+    }
+
+    template <class U>
+    bool operator==(const CountingAllocator<U> &other) const
+    {
+        return allocationsCount_ == other.allocationsCount_;
+    }
+
+    template <class U>
+    bool operator!=(const CountingAllocator<U> &other) const
+    {
+        return allocationsCount_ != other.allocationsCount_;
+    }
+};
+
+// Sort benchmark element of BYTES bytes whose first word is the key. Copies
+// and moves are counted.
+template <int BYTES>
+class BenchmarkElement
+{
+    long words_[BYTES / sizeof(long)];
+
+public:
+    static long long movesCount;
+
+    BenchmarkElement()
+    {
+        std::fill(words_, words_ + BYTES / sizeof(long), 0);
+    }
+
+    explicit BenchmarkElement(long key)
+    {
+        std::fill(words_, words_ + BYTES / sizeof(long), key);
+    }
+
+    BenchmarkElement(const BenchmarkElement &other)
+    {
+        ++movesCount;
+        std::copy(other.words_, other.words_ + BYTES / sizeof(long), words_);
+    }
+
+    BenchmarkElement &operator=(const BenchmarkElement &other)
+    {
+        ++movesCount;
+        std::copy(other.words_, other.words_ + BYTES / sizeof(long), words_);
+        return *this;
+    }
+
+    long GetKey() const
+    {
+        return words_[0];
+    }
+};
+
+template <int BYTES>
+long long BenchmarkElement<BYTES>::movesCount = 0;
+
+template <class Element>
+class CountingLess
+{
+    long long *comparisonsCount_;
+
+public:
+    explicit CountingLess(long long &comparisonsCount) : comparisonsCount_(&comparisonsCount)
+    {
+    }
+
+    bool operator()(const Element &first, const Element &second) const
+    {
+        ++*comparisonsCount_;
+        return first.GetKey() < second.GetKey();
+    }
+};
+
+template <class Element>
+class BenchmarkKey
+{
+public:
+    unsigned long long operator()(const Element &element) const
+    {
+        return static_cast<unsigned long long>(element.GetKey()) ^ (1ULL << 63);
+    }
+};
+
+enum HardwareEvent
+{
+    CACHE_MISSES_EVENT
+};
+
+// Counts a hardware event of this process between Start and Stop. A counter
+// that can not be opened (no permission, no PMU or not Linux) reads as -1.
+class HardwareCounter
+{
+    int descriptor_;
+
+    HardwareCounter(const HardwareCounter &);
+    HardwareCounter &operator=(const HardwareCounter &);
+
+public:
+    explicit HardwareCounter(HardwareEvent event) : descriptor_(-1)
+    {
+#if defined(__linux__)
+        perf_event_attr attributes;
+        memset(&attributes, 0, sizeof(attributes));
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.size = sizeof(attributes);
+        switch (event)
+        {
+        case CACHE_MISSES_EVENT:
+            attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        }
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        descriptor_ = syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+#else
+        (void)event;
+#endif
+    }
+
+    ~HardwareCounter()
+    {
+        if (descriptor_ >= 0)
+            close(descriptor_);
+    }
+
+    void Start()
+    {
+#if defined(__linux__)
+        if (descriptor_ >= 0)
+        {
+            ioctl(descriptor_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(descriptor_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long Stop()
+    {
+        long long value = -1;
+#if defined(__linux__)
+        if (descriptor_ >= 0)
+        {
+            ioctl(descriptor_, PERF_EVENT_IOC_DISABLE, 0);
+            if (sizeof(value) != read(descriptor_, &value, sizeof(value)))
+                value = -1;
+        }
+#endif
+        return value;
+    }
+};
+
+enum SortAlgorithm
+{
+    MERGE_SORT,
+    RADIX_SORT,
+    STD_SORT,
+    STD_STABLE_SORT
+};
+
+const char *const SORT_ALGORITHM_NAMES[] = { "MergeSort", "RadixSort", "std::sort", "std::stable_sort" };
+const int SORT_ALGORITHMS_COUNT = 4;
+
+enum KeyDistribution
+{
+    RANDOM_KEYS,
+    SORTED_KEYS,
+    REVERSE_KEYS,
+    FEW_UNIQUE_KEYS,
+    ORGAN_PIPE_KEYS
+};
+
+const char *const KEY_DISTRIBUTION_NAMES[] = { "random", "sorted", "reverse", "few-unique", "organ-pipe" };
+const int KEY_DISTRIBUTIONS_COUNT = 5;
+const int FEW_UNIQUE_KEYS_COUNT = 16;
+
+std::vector<long> GenerateKeys(KeyDistribution distribution, int count)
+{
+    std::mt19937_64 random(count);
+    std::vector<long> keys(count);
+    for (int position = 0; position < count; ++position)
+    {
+        switch (distribution)
+        {
+        case RANDOM_KEYS:
+            keys[position] = static_cast<long>(random());
+            break;
+        case SORTED_KEYS:
+            keys[position] = position;
+            break;
+        case REVERSE_KEYS:
+            keys[position] = count - position;
+            break;
+        case FEW_UNIQUE_KEYS:
+            keys[position] = random() % FEW_UNIQUE_KEYS_COUNT;
+            break;
+        case ORGAN_PIPE_KEYS:
+            keys[position] = std::min(position, count - position);
+            break;
+        }
+    }
+    return keys;
+}
+
+// Prints a count as a JSON number, or null if it is -1 (not counted)
+void PrintCount(long long count)
+{
+    if (count < 0)
+        printf("null");
+    else
+        printf("%lld", count);
+}
+
+// Sorts one input with one algorithm and prints the measurements as a JSON
+// object
+template <int BYTES>
+void BenchmarkSort(SortAlgorithm algorithm, 
+                   KeyDistribution distribution, 
+                   const std::vector<long> &keys,
+                   bool isFirst)
+{
+    typedef BenchmarkElement<BYTES> Element;
+    std::vector<Element> elements(keys.begin(), keys.end());
+    long long allocationsCount = 0;
+    std::vector<Element, CountingAllocator<Element> > buffer(
+        (CountingAllocator<Element>(allocationsCount)));
+    long long comparisonsCount = 0;
+    CountingLess<Element> less(comparisonsCount);
+    HardwareCounter cacheMisses(CACHE_MISSES_EVENT);
+    Element::movesCount = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    cacheMisses.Start();
+    switch (algorithm)
+    {
+    case MERGE_SORT:
+        MergeSort<typename std::vector<Element>::iterator, Element, CountingLess<Element> >
+            (elements.begin(), elements.end(), buffer, less);
+        break;
+    case RADIX_SORT:
+        RadixSort<typename std::vector<Element>::iterator, Element, BenchmarkKey<Element> >
+            (elements.begin(), elements.end(), buffer, BenchmarkKey<Element>());
+        break;
+    case STD_SORT:
+        std::sort(elements.begin(), elements.end(), less);
+        break;
+    case STD_STABLE_SORT:
+        std::stable_sort(elements.begin(), elements.end(), less);
+        break;
+    }
+    long long cacheMissesCount = cacheMisses.Stop();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long long movesCount = Element::movesCount;
+    // The standard sorts take their memory where the counter does not see it
+    long long allocations = (MERGE_SORT == algorithm || RADIX_SORT == algorithm) ? 
+        allocationsCount : -1;
+    for (size_t position = 1; position < elements.size(); ++position)
+    {
+        if (elements[position].GetKey() < elements[position - 1].GetKey())
+            throw std::logic_error(std::string(SORT_ALGORITHM_NAMES[algorithm]) + " did not sort");
+    }
+    printf("%s\n  {\"algorithm\": \"%s\", \"distribution\": \"%s\", "
+           "\"element_bytes\": %d, \"count\": %d, \"ns_per_element\": %.3f, "
+           "\"comparisons\": %lld, \"moves\": %lld, \"allocations\": ",
+           isFirst ? "" : ",", SORT_ALGORITHM_NAMES[algorithm], 
+           KEY_DISTRIBUTION_NAMES[distribution], BYTES, static_cast<int>(keys.size()),
+           keys.empty() ? 0.0 : seconds * 1e9 / keys.size(), 
+           comparisonsCount, movesCount);
+    PrintCount(allocations);
+    printf(", \"cache_misses\": ");
+    PrintCount(cacheMissesCount);
+    printf("}");
+}
+
+// Prints a JSON array with a measurement for every algorithm, key
+// distribution and element size. Comparisons are not counted for RadixSort,
+// allocations are null for the standard sorts, and cache misses are null
+// where hardware counters are unavailable.
+void BenchmarkSorts(int count)
+{
+    printf("[");
+    bool isFirst = true;
+    for (int distribution = 0; distribution < KEY_DISTRIBUTIONS_COUNT; ++distribution)
+    {
+        std::vector<long> keys = GenerateKeys(static_cast<KeyDistribution>(distribution), count);
+        for (int algorithm = 0; algorithm < SORT_ALGORITHMS_COUNT; ++algorithm)
+        {
+            SortAlgorithm sortAlgorithm = static_cast<SortAlgorithm>(algorithm);
+            KeyDistribution keyDistribution = static_cast<KeyDistribution>(distribution);
+            BenchmarkSort<8>(sortAlgorithm, keyDistribution, keys, isFirst);
+            BenchmarkSort<16>(sortAlgorithm, keyDistribution, keys, false);
+            BenchmarkSort<32>(sortAlgorithm, keyDistribution, keys, false);
+            BenchmarkSort<64>(sortAlgorithm, keyDistribution, keys, false);
+            isFirst = false;
+        }
+    }
+    printf("\n]\n");
+    fflush(stdout);
+}
+
+const int DEFAULT_BENCHMARK_COUNT = 1000000;
+
+// Usage: 2-2 [--threads count | --external | --updates | --queries]
+//        2-2 --benchmark-sort [count]
+// With --threads the players are sorted by count threads (0 means one per core).
+// With --external sorted runs of players are kept in temporary files, so
+// rosters larger than memory can be processed. With --updates the players
+// are followed by the number of updates and the updates themselves, and
+// with --queries by the number of queries and the queries. --benchmark-sort
+// reads nothing and prints sort measurements as JSON.
+int main(int argc, char * argv[])
+{
+    if (argc > 1 && std::string("--benchmark-sort") == argv[1])
+    {
+        BenchmarkSorts(argc > 2 ? atoi(argv[2]) : DEFAULT_BENCHMARK_COUNT);
+        return 0;
+    }
+    FastInput input(stdin);
+    BufferedWriter writer(stdout);
+    if (argc > 1 && std::string("--external") == argv[1])
+    {
+        try
+        {
+            BuildAndPrintSoccerTeamExternally(input, writer);
+        }
+        catch (const std::overflow_error &error)
+        {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (argc > 1 && std::string("--updates") == argv[1])
+    {
+        try
+        {
+            MaintainSoccerTeam(input, writer);
+        }
+        catch (const std::overflow_error &error)
+        {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (argc > 1 && std::string("--queries") == argv[1])
+    {
+        try
+        {
+            AnswerTeamQueries(input, writer);
+        }
+        catch (const std::overflow_error &error)
+        {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    int threadsCount = 1;
+    if (argc > 2 && std::string("--threads") == argv[1])
+        threadsCount = atoi(argv[2]);
+    PlayerTable players = ReadPlayerTable(input);
+    try
+    {
+        RowRange team = BuildSoccerTeam(players, threadsCount);
+        PrintSoccerTeam(players, team, writer);
+    }
+    catch (const std::overflow_error &error)
+    {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
     return 0;
 }
@@ -1,10 +1,25 @@
-#include<iostream>
 #include<vector>
 #include<algorithm>
+#include<utility>
+#include<queue>
+#include<functional>
+#include<cstdio>
+#include<cstring>
+#include<cstdlib>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<sys/wait.h>
+#include<sys/resource.h>
+#include<time.h>
+#include<climits>
+#include<cmath>
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#include<atomic>
+#include<random>
 
-using std::cin;
-using std::cout;
-using std::endl;
 using std::vector;
 using std::swap;
 
@@ -13,8 +28,6 @@ const int GRAY = 1;
 const int BLACK = 2;
 const int INIT_COMPONENT_INDEX = -1;
 
-typedef vector<vector<int> > vectorOfIntVectors;
-
 enum GameResult
 {
     FIRST_WIN = 1,
@@ -71,57 +84,144 @@ public:
 };
 
 
+// Compressed sparse row storage: the targets of all edges leaving a vertex
+// lie contiguously in one array, so the graph is two allocations in total
+class DirectedGraph
+{
+private:
+    vector<int> firstEdge;
+    vector<int> targets;
+public:
+    DirectedGraph() : firstEdge(1, 0)
+    {
+    }
+    int GetVertexCount() const
+    {
+        return firstEdge.size() - 1;
+    }
+    int GetEdgeCount() const
+    {
+        return targets.size();
+    }
+    int GetFirstEdge(int vertexIndex) const
+    {
+        return firstEdge[vertexIndex];
+    }
+    int GetLastEdge(int vertexIndex) const
+    {
+        return firstEdge[vertexIndex + 1];
+    }
+    int GetEdgeTarget(int edgeIndex) const
+    {
+        return targets[edgeIndex];
+    }
+    // The first pass counts out-degrees with StartCounting and CountEdge,
+    // the second places the edges with StartFilling and AddEdge in the same
+    // order; edges of a vertex keep their insertion order
+    void StartCounting(int vertexCount)
+    {
+        firstEdge.assign(vertexCount + 2, 0);
+        targets.clear();
+    }
+    void CountEdge(int from)
+    {
+        ++firstEdge[from + 2];
+    }
+    void StartFilling()
+    {
+        for (size_t vertexIndex = 2; vertexIndex < firstEdge.size(); ++vertexIndex)
+        {
+            firstEdge[vertexIndex] += firstEdge[vertexIndex - 1];
+        }
+        targets.resize(firstEdge.back());
+    }
+    // firstEdge[from + 1] serves as the fill cursor of the vertex and ends
+    // up at the end of its edges, which is where the next vertex begins
+    void AddEdge(int from, int to)
+    {
+        targets[firstEdge[from + 1]++] = to;
+    }
+    void FinishFilling()
+    {
+        firstEdge.pop_back();
+    }
+};
+
+struct DFSFrame
+{
+    int vertex;
+    int nextEdge;
+};
+
+// Keeps the path on an explicit stack, so long chains of wins cannot
+// overflow the call stack; path is only scratch space shared between calls
 template <class ActionBefore, class ActionAfter>
 void DFSWithExtraActions(int vertexIndex, 
     vector<int> & color, 
-    const vectorOfIntVectors & incidenceMatrix,
+    const DirectedGraph & graph,
     ActionBefore actionBefore, 
-    ActionAfter actionAfter)
+    ActionAfter actionAfter,
+    vector<DFSFrame> & path)
 {
     actionBefore(vertexIndex);
     color[vertexIndex] = GRAY;
-    for (int i = 0; i < incidenceMatrix[vertexIndex].size(); ++i)
+    DFSFrame root = {vertexIndex, graph.GetFirstEdge(vertexIndex)};
+    path.clear();
+    path.push_back(root);
+    while (!path.empty())
     {
-        if (WHITE == color[incidenceMatrix[vertexIndex][i]])
+        DFSFrame & frame = path.back();
+        if (frame.nextEdge == graph.GetLastEdge(frame.vertex))
+        {
+            color[frame.vertex] = BLACK;
+            actionAfter(frame.vertex);
+            path.pop_back();
+            continue;
+        }
+        int nextVertex = graph.GetEdgeTarget(frame.nextEdge++);
+        if (WHITE == color[nextVertex])
         {
-            DFSWithExtraActions(incidenceMatrix[vertexIndex][i], 
-                                color, 
-                                incidenceMatrix, 
-                                actionBefore, 
-                                actionAfter);
+            actionBefore(nextVertex);
+            color[nextVertex] = GRAY;
+            DFSFrame next = {nextVertex, graph.GetFirstEdge(nextVertex)};
+            path.push_back(next);
         }
     }
-    color[vertexIndex] = BLACK;
-    actionAfter(vertexIndex);
 }
 
 class StronglyConnectedComponentsInfo
 {
 private:
-    vectorOfIntVectors stronglyConnectedComponents;
     vector<int> componentIndex;
+    vector<int> componentSizes;
 public:
-    explicit StronglyConnectedComponentsInfo(vector<int> componentIndex):
-    componentIndex(componentIndex)
-    {
-    }
-    const vectorOfIntVectors & GetStronglyConnectedComponents() const
-    {
-        return stronglyConnectedComponents;
-    }
-    void BuildStronglyConnectedComponents()
+    // Takes the contents of newComponentIndex over instead of copying them
+    void SetComponentIndex(vector<int> & newComponentIndex)
     {
-        for (int componentIndexCount = 0; componentIndexCount < componentIndex.size(); 
-            ++componentIndexCount)
+        componentIndex.swap(newComponentIndex);
+        componentSizes.clear();
+        for (size_t vertexIndex = 0; vertexIndex < componentIndex.size(); ++vertexIndex)
         {
-            if (stronglyConnectedComponents.size() <= componentIndex[componentIndexCount])
+            size_t component = componentIndex[vertexIndex];
+            if (componentSizes.size() <= component)
             {
-                stronglyConnectedComponents.resize(componentIndex[componentIndexCount] + 1);
+                componentSizes.resize(component + 1, 0);
             }
-            stronglyConnectedComponents[componentIndex[componentIndexCount]].
-                push_back(componentIndexCount);
+            ++componentSizes[component];
         }
     }
+    const vector<int> & GetComponentIndex() const
+    {
+        return componentIndex;
+    }
+    int GetComponentsCount() const
+    {
+        return componentSizes.size();
+    }
+    int GetComponentSize(int component) const
+    {
+        return componentSizes[component];
+    }
 };
 
 class StronglyConnectedComponentsReachabilityInfo
@@ -130,19 +230,18 @@ private:
     StronglyConnectedComponentsInfo stronglyConnectedComponentsInfo;
     vector<bool> reachable;
 public:
-    explicit StronglyConnectedComponentsReachabilityInfo(
-        const StronglyConnectedComponentsInfo & stronglyConnectedComponentsInfo):
-    stronglyConnectedComponentsInfo(stronglyConnectedComponentsInfo)
-    {
-    }
-    void Init(int vertexCount)
+    void Init(int componentsCount)
     {
-        reachable.resize(vertexCount, false);
+        reachable.assign(componentsCount, false);
     }
     void SetReachable(int index, bool value)
     {
         reachable[index] = value;
     }
+    StronglyConnectedComponentsInfo & GetStronglyConnectedComponentsInfo()
+    {
+        return stronglyConnectedComponentsInfo;
+    }
     const StronglyConnectedComponentsInfo & GetStronglyConnectedComponentsInfo() const
     {
         return stronglyConnectedComponentsInfo;
@@ -153,29 +252,42 @@ public:
     }
 };
 
-vectorOfIntVectors ReverseDirectedGraph(const vectorOfIntVectors & directedGraph)
+DirectedGraph ReverseDirectedGraph(const DirectedGraph & directedGraph)
 {
-    vectorOfIntVectors reversedDirectedGraph;
-    vector<int> incidenceMatrixInitVector;
-    reversedDirectedGraph.resize(directedGraph.size(), incidenceMatrixInitVector);
-    for (int row = 0; row < directedGraph.size(); ++row)
+    DirectedGraph reversedDirectedGraph;
+    reversedDirectedGraph.StartCounting(directedGraph.GetVertexCount());
+    for (int edge = 0; edge < directedGraph.GetEdgeCount(); ++edge)
+    {
+        reversedDirectedGraph.CountEdge(directedGraph.GetEdgeTarget(edge));
+    }
+    reversedDirectedGraph.StartFilling();
+    for (int row = 0; row < directedGraph.GetVertexCount(); ++row)
     {
-        for (int column = 0; column < directedGraph[row].size(); ++column)
+        for (int edge = directedGraph.GetFirstEdge(row); 
+            edge < directedGraph.GetLastEdge(row); 
+            ++edge)
         {
-            reversedDirectedGraph[directedGraph[row][column]].push_back(row);
+            reversedDirectedGraph.AddEdge(directedGraph.GetEdgeTarget(edge), row);
         }
     }
+    reversedDirectedGraph.FinishFilling();
     return reversedDirectedGraph;
 }
 
-StronglyConnectedComponentsReachabilityInfo 
-    ComputeStronglyConnectedComponentsReachability(const vectorOfIntVectors & incidenceMatrix)
+// Kosaraju: a DFS over the graph orders the vertices by finishing time and a
+// second one over the transposed graph collects the components
+void ComputeStronglyConnectedComponentsReachabilityKosaraju(
+    const DirectedGraph & incidenceMatrix,
+    StronglyConnectedComponentsReachabilityInfo & stronglyConnectedComponentsReachabilityInfo)
 {
-    vectorOfIntVectors matrixTransponed = ReverseDirectedGraph(incidenceMatrix);
+    DirectedGraph matrixTransponed = ReverseDirectedGraph(incidenceMatrix);
+    int vertexCount = matrixTransponed.GetVertexCount();
     vector<int> timeOutOrdered;
-    vector<int> color(matrixTransponed.size(), 0); 
+    timeOutOrdered.reserve(vertexCount);
+    vector<int> color(vertexCount, 0); 
+    vector<DFSFrame> path;
     DoNothing doNothing;
-    for (int peopleCounter = 0; peopleCounter < matrixTransponed.size(); ++peopleCounter)
+    for (int peopleCounter = 0; peopleCounter < vertexCount; ++peopleCounter)
     {
         if (WHITE == color[peopleCounter])
         {
@@ -184,16 +296,17 @@ StronglyConnectedComponentsReachabilityInfo
                 color,
                 incidenceMatrix,
                 doNothing,
-                buildingTimesOut);
+                buildingTimesOut,
+                path);
         }
     }
     color.clear();
-    color.resize(matrixTransponed.size(), 0);
+    color.resize(vertexCount, 0);
     vector<int> componentIndex;
-    componentIndex.resize(matrixTransponed.size(), INIT_COMPONENT_INDEX);
+    componentIndex.resize(vertexCount, INIT_COMPONENT_INDEX);
     BuildingStronglyConnectedComponents buildingStronglyConnectedComponents(
                 componentIndex);
-    for (int peopleCounter = matrixTransponed.size() - 1; peopleCounter >= 0; --peopleCounter)
+    for (int peopleCounter = vertexCount - 1; peopleCounter >= 0; --peopleCounter)
     {
         if (WHITE == color[timeOutOrdered[peopleCounter]])
         {
@@ -202,100 +315,2359 @@ StronglyConnectedComponentsReachabilityInfo
                 color,
                 matrixTransponed,
                 buildingStronglyConnectedComponents,
-                doNothing);
+                doNothing,
+                path);
             buildingStronglyConnectedComponents.IncrementComponentsCount();
         }
     }
-    StronglyConnectedComponentsInfo stronglyConnectedComponentsInfo(componentIndex);
-    stronglyConnectedComponentsInfo.BuildStronglyConnectedComponents();
-    StronglyConnectedComponentsReachabilityInfo 
-        stronglyConnectedComponentsReachabilityInfo(stronglyConnectedComponentsInfo);
-    stronglyConnectedComponentsReachabilityInfo.Init(matrixTransponed.size());
-    for (int peopleCounter = 0; peopleCounter < matrixTransponed.size(); ++peopleCounter)
+    // Components never outnumber vertices
+    stronglyConnectedComponentsReachabilityInfo.Init(vertexCount);
+    for (int peopleCounter = 0; peopleCounter < vertexCount; ++peopleCounter)
     {
-        for (int edgeCounter = 0; 
-            edgeCounter < matrixTransponed[peopleCounter].size(); 
+        for (int edgeCounter = matrixTransponed.GetFirstEdge(peopleCounter); 
+            edgeCounter < matrixTransponed.GetLastEdge(peopleCounter); 
             ++edgeCounter)
         {
             if (componentIndex[peopleCounter] != 
-                componentIndex[matrixTransponed[peopleCounter][edgeCounter]])
+                componentIndex[matrixTransponed.GetEdgeTarget(edgeCounter)])
             {
                 stronglyConnectedComponentsReachabilityInfo.
                     SetReachable(componentIndex[peopleCounter], true);
             }
         }
     }
-    return stronglyConnectedComponentsReachabilityInfo;
+    stronglyConnectedComponentsReachabilityInfo.GetStronglyConnectedComponentsInfo().
+        SetComponentIndex(componentIndex);
+}
+
+struct PearceFrame
+{
+    int vertex;
+    int nextEdge;
+    bool root;
+};
+
+// Pearce's variant of Tarjan's algorithm: a single DFS over the graph itself
+// with one word per vertex. The word is 0 for a vertex not visited yet, the
+// lowest visit index reached so far while its component is open, and the
+// complement of its component once the component is closed. An edge into a
+// closed component always comes from another component, so the reachability
+// flags are set during the same DFS.
+void ComputeStronglyConnectedComponentsReachabilityPearce(
+    const DirectedGraph & incidenceMatrix,
+    StronglyConnectedComponentsReachabilityInfo & stronglyConnectedComponentsReachabilityInfo)
+{
+    int vertexCount = incidenceMatrix.GetVertexCount();
+    vector<int> rindex(vertexCount, 0);
+    vector<PearceFrame> path;
+    vector<int> openVertices;
+    int visitIndex = 1;
+    int componentsCount = 0;
+    stronglyConnectedComponentsReachabilityInfo.Init(vertexCount);
+    for (int peopleCounter = 0; peopleCounter < vertexCount; ++peopleCounter)
+    {
+        if (0 != rindex[peopleCounter])
+        {
+            continue;
+        }
+        rindex[peopleCounter] = visitIndex++;
+        PearceFrame start = {peopleCounter, incidenceMatrix.GetFirstEdge(peopleCounter), true};
+        path.push_back(start);
+        while (!path.empty())
+        {
+            PearceFrame & frame = path.back();
+            int vertex = frame.vertex;
+            if (frame.nextEdge < incidenceMatrix.GetLastEdge(vertex))
+            {
+                int target = incidenceMatrix.GetEdgeTarget(frame.nextEdge);
+                if (0 == rindex[target])
+                {
+                    // The edge is looked at again once the target is finished
+                    rindex[target] = visitIndex++;
+                    PearceFrame next = {target, incidenceMatrix.GetFirstEdge(target), true};
+                    path.push_back(next);
+                    continue;
+                }
+                ++frame.nextEdge;
+                if (rindex[target] < 0)
+                {
+                    stronglyConnectedComponentsReachabilityInfo.
+                        SetReachable(~rindex[target], true);
+                }
+                else if (rindex[target] < rindex[vertex])
+                {
+                    rindex[vertex] = rindex[target];
+                    frame.root = false;
+                }
+                continue;
+            }
+            bool root = frame.root;
+            path.pop_back();
+            if (!root)
+            {
+                openVertices.push_back(vertex);
+                continue;
+            }
+            while (!openVertices.empty() && rindex[openVertices.back()] >= rindex[vertex])
+            {
+                rindex[openVertices.back()] = ~componentsCount;
+                openVertices.pop_back();
+            }
+            rindex[vertex] = ~componentsCount;
+            ++componentsCount;
+        }
+    }
+    for (int peopleCounter = 0; peopleCounter < vertexCount; ++peopleCounter)
+    {
+        rindex[peopleCounter] = ~rindex[peopleCounter];
+    }
+    stronglyConnectedComponentsReachabilityInfo.GetStronglyConnectedComponentsInfo().
+        SetComponentIndex(rindex);
 }
 
-vectorOfIntVectors BuildIncidenceMatrix(const vector<Game> & games, int peopleNumber)
+DirectedGraph BuildIncidenceMatrix(const vector<Game> & games, int peopleNumber)
 {
-    vectorOfIntVectors incidenceMatrix;
-    vector<int> matrixInitVector;
-    incidenceMatrix.resize(peopleNumber, matrixInitVector);
-    for (int gameCounter = 0; gameCounter < games.size(); ++gameCounter)
+    DirectedGraph incidenceMatrix;
+    incidenceMatrix.StartCounting(peopleNumber);
+    for (size_t gameCounter = 0; gameCounter < games.size(); ++gameCounter)
+    {
+        if (DRAW != games[gameCounter].gameResult)
+        {
+            incidenceMatrix.CountEdge(games[gameCounter].winner);
+        }
+    }
+    incidenceMatrix.StartFilling();
+    for (size_t gameCounter = 0; gameCounter < games.size(); ++gameCounter)
     {
         if (DRAW != games[gameCounter].gameResult)
         {
-            incidenceMatrix[games[gameCounter].winner].push_back(games[gameCounter].looser);
+            incidenceMatrix.AddEdge(games[gameCounter].winner, games[gameCounter].looser);
         }
     }
+    incidenceMatrix.FinishFilling();
     return incidenceMatrix;
 }
 
-int GetTeamSize(const vector<Game> & games, int peopleNumber)
+class ParallelTask
+{
+public:
+    virtual ~ParallelTask()
+    {
+    }
+    virtual void operator()(int threadIndex) = 0;
+};
+
+// Keeps its workers alive between tasks, so a phase costs a wake-up rather
+// than a thread start; the calling thread takes part as thread 0
+class ThreadPool
+{
+private:
+    vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable taskReady;
+    std::condition_variable taskDone;
+    ParallelTask * task;
+    long long generation;
+    int runningCount;
+    bool stopping;
+
+    ThreadPool(const ThreadPool &);
+    ThreadPool & operator=(const ThreadPool &);
+
+    void Work(int threadIndex)
+    {
+        long long seenGeneration = 0;
+        for (;;)
+        {
+            ParallelTask * currentTask = NULL;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                while (!stopping && generation == seenGeneration)
+                {
+                    taskReady.wait(lock);
+                }
+                if (stopping)
+                {
+                    return;
+                }
+                seenGeneration = generation;
+                currentTask = task;
+            }
+            (*currentTask)(threadIndex);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (0 == --runningCount)
+            {
+                taskDone.notify_one();
+            }
+        }
+    }
+
+public:
+    explicit ThreadPool(int threadsCount) :
+    task(NULL), generation(0), runningCount(0), stopping(false)
+    {
+        for (int threadIndex = 1; threadIndex < threadsCount; ++threadIndex)
+        {
+            workers.push_back(std::thread(&ThreadPool::Work, this, threadIndex));
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        taskReady.notify_all();
+        for (size_t workerIndex = 0; workerIndex < workers.size(); ++workerIndex)
+        {
+            workers[workerIndex].join();
+        }
+    }
+
+    int GetThreadsCount() const
+    {
+        return workers.size() + 1;
+    }
+
+    // Runs the task on every thread and returns once all of them finish
+    void Run(ParallelTask & newTask)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = &newTask;
+            runningCount = workers.size();
+            ++generation;
+        }
+        taskReady.notify_all();
+        newTask(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        while (runningCount > 0)
+        {
+            taskDone.wait(lock);
+        }
+    }
+};
+
+const int NO_LABEL = -1;
+
+// Rounds of the coloring algorithm over the vertices still without a
+// component. A round first trims vertices with no remaining in- or out-edges,
+// each a component of its own; then every vertex takes the largest id among
+// the vertices that reach it, and every vertex whose color is its own id
+// collects its component by a backward search among vertices of its color.
+// Components are labelled with one of their vertices.
+class ParallelStronglyConnectedComponents : public ParallelTask
+{
+private:
+    enum Phase
+    {
+        COUNT_DEGREES,
+        TRIM,
+        INIT_COLORS,
+        PROPAGATE_COLORS,
+        COLLECT_COMPONENTS,
+        MARK_INCOMING
+    };
+
+    const DirectedGraph & graph;
+    const DirectedGraph & reversedGraph;
+    ThreadPool & pool;
+    Phase phase;
+    vector<std::atomic<int> > label;
+    vector<std::atomic<int> > color;
+    vector<std::atomic<int> > inCount;
+    vector<std::atomic<int> > outCount;
+    vector<std::atomic<bool> > hasIncoming;
+    std::atomic<int> activeCount;
+    vector<vector<int> > stacks;
+
+    ParallelStronglyConnectedComponents(const ParallelStronglyConnectedComponents &);
+    ParallelStronglyConnectedComponents & operator=(
+        const ParallelStronglyConnectedComponents &);
+
+    bool IsActive(int vertexIndex) const
+    {
+        return NO_LABEL == label[vertexIndex].load(std::memory_order_relaxed);
+    }
+
+    int CountActiveNeighbours(const DirectedGraph & edges, int vertexIndex) const
+    {
+        int count = 0;
+        for (int edge = edges.GetFirstEdge(vertexIndex); 
+            edge < edges.GetLastEdge(vertexIndex); 
+            ++edge)
+        {
+            if (IsActive(edges.GetEdgeTarget(edge)))
+            {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    bool Claim(int vertexIndex, int component)
+    {
+        int expected = NO_LABEL;
+        return label[vertexIndex].compare_exchange_strong(expected, component, 
+                                                          std::memory_order_relaxed);
+    }
+
+    // The thread whose decrement reaches zero claims the vertex, so every
+    // trimmed vertex is expanded exactly once
+    void ReleaseNeighbours(const DirectedGraph & edges, 
+        vector<std::atomic<int> > & counts, 
+        int vertexIndex, 
+        vector<int> & stack)
+    {
+        for (int edge = edges.GetFirstEdge(vertexIndex); 
+            edge < edges.GetLastEdge(vertexIndex); 
+            ++edge)
+        {
+            int neighbour = edges.GetEdgeTarget(edge);
+            if (1 == counts[neighbour].fetch_sub(1, std::memory_order_relaxed) && 
+                Claim(neighbour, neighbour))
+            {
+                stack.push_back(neighbour);
+            }
+        }
+    }
+
+    void Trim(int vertexIndex, vector<int> & stack)
+    {
+        if (IsActive(vertexIndex) && 
+            (0 == inCount[vertexIndex].load(std::memory_order_relaxed) || 
+             0 == outCount[vertexIndex].load(std::memory_order_relaxed)) && 
+            Claim(vertexIndex, vertexIndex))
+        {
+            stack.push_back(vertexIndex);
+        }
+        while (!stack.empty())
+        {
+            int trimmed = stack.back();
+            stack.pop_back();
+            ReleaseNeighbours(graph, inCount, trimmed, stack);
+            ReleaseNeighbours(reversedGraph, outCount, trimmed, stack);
+        }
+    }
+
+    // Whoever raises a color pushes the vertex again, so the colors are
+    // stable once every stack is empty
+    void PropagateColors(int vertexIndex, vector<int> & stack)
+    {
+        stack.push_back(vertexIndex);
+        while (!stack.empty())
+        {
+            int source = stack.back();
+            stack.pop_back();
+            int sourceColor = color[source].load(std::memory_order_relaxed);
+            for (int edge = graph.GetFirstEdge(source); 
+                edge < graph.GetLastEdge(source); 
+                ++edge)
+            {
+                int target = graph.GetEdgeTarget(edge);
+                if (!IsActive(target))
+                {
+                    continue;
+                }
+                int targetColor = color[target].load(std::memory_order_relaxed);
+                while (targetColor < sourceColor)
+                {
+                    if (color[target].compare_exchange_weak(targetColor, sourceColor, 
+                                                            std::memory_order_relaxed))
+                    {
+                        stack.push_back(target);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // Only the root of a color visits vertices of that color, so the
+    // searches of different roots never meet
+    void CollectComponent(int root, vector<int> & stack)
+    {
+        label[root].store(root, std::memory_order_relaxed);
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            int target = stack.back();
+            stack.pop_back();
+            for (int edge = reversedGraph.GetFirstEdge(target); 
+                edge < reversedGraph.GetLastEdge(target); 
+                ++edge)
+            {
+                int source = reversedGraph.GetEdgeTarget(edge);
+                if (IsActive(source) && root == color[source].load(std::memory_order_relaxed))
+                {
+                    label[source].store(root, std::memory_order_relaxed);
+                    stack.push_back(source);
+                }
+            }
+        }
+    }
+
+    void MarkIncoming(int vertexIndex)
+    {
+        int component = label[vertexIndex].load(std::memory_order_relaxed);
+        for (int edge = graph.GetFirstEdge(vertexIndex); 
+            edge < graph.GetLastEdge(vertexIndex); 
+            ++edge)
+        {
+            int targetComponent = label[graph.GetEdgeTarget(edge)].load(std::memory_order_relaxed);
+            if (component != targetComponent)
+            {
+                hasIncoming[targetComponent].store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+
+public:
+    ParallelStronglyConnectedComponents(const DirectedGraph & graph, 
+        const DirectedGraph & reversedGraph, 
+        ThreadPool & pool) :
+    graph(graph), reversedGraph(reversedGraph), pool(pool), phase(COUNT_DEGREES),
+    label(graph.GetVertexCount()), color(graph.GetVertexCount()), 
+    inCount(graph.GetVertexCount()), outCount(graph.GetVertexCount()), 
+    hasIncoming(graph.GetVertexCount()), activeCount(0), stacks(pool.GetThreadsCount())
+    {
+        for (int vertexIndex = 0; vertexIndex < graph.GetVertexCount(); ++vertexIndex)
+        {
+            label[vertexIndex].store(NO_LABEL, std::memory_order_relaxed);
+            hasIncoming[vertexIndex].store(false, std::memory_order_relaxed);
+        }
+    }
+
+    void operator()(int threadIndex)
+    {
+        int vertexCount = graph.GetVertexCount();
+        int threadsCount = pool.GetThreadsCount();
+        int begin = static_cast<long long>(vertexCount) * threadIndex / threadsCount;
+        int end = static_cast<long long>(vertexCount) * (threadIndex + 1) / threadsCount;
+        vector<int> & stack = stacks[threadIndex];
+        if (PROPAGATE_COLORS == phase)
+        {
+            // Largest colors first, so fewer vertices are raised twice
+            for (int vertexIndex = end - 1; vertexIndex >= begin; --vertexIndex)
+            {
+                if (IsActive(vertexIndex))
+                {
+                    PropagateColors(vertexIndex, stack);
+                }
+            }
+            return;
+        }
+        int active = 0;
+        for (int vertexIndex = begin; vertexIndex < end; ++vertexIndex)
+        {
+            if (MARK_INCOMING == phase)
+            {
+                MarkIncoming(vertexIndex);
+                continue;
+            }
+            if (!IsActive(vertexIndex))
+            {
+                continue;
+            }
+            switch (phase)
+            {
+            case COUNT_DEGREES:
+                inCount[vertexIndex].store(CountActiveNeighbours(reversedGraph, vertexIndex),
+                                           std::memory_order_relaxed);
+                outCount[vertexIndex].store(CountActiveNeighbours(graph, vertexIndex),
+                                            std::memory_order_relaxed);
+                ++active;
+                break;
+            case TRIM:
+                Trim(vertexIndex, stack);
+                break;
+            case INIT_COLORS:
+                color[vertexIndex].store(vertexIndex, std::memory_order_relaxed);
+                break;
+            case COLLECT_COMPONENTS:
+                if (vertexIndex == color[vertexIndex].load(std::memory_order_relaxed))
+                {
+                    CollectComponent(vertexIndex, stack);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        if (COUNT_DEGREES == phase)
+        {
+            activeCount.fetch_add(active, std::memory_order_relaxed);
+        }
+    }
+
+    void Run(StronglyConnectedComponentsReachabilityInfo & stronglyConnectedComponentsReachabilityInfo)
+    {
+        for (;;)
+        {
+            activeCount.store(0, std::memory_order_relaxed);
+            phase = COUNT_DEGREES;
+            pool.Run(*this);
+            if (0 == activeCount.load(std::memory_order_relaxed))
+            {
+                break;
+            }
+            const Phase roundPhases[] = {TRIM, INIT_COLORS, PROPAGATE_COLORS, COLLECT_COMPONENTS};
+            for (int phaseIndex = 0; phaseIndex < 4; ++phaseIndex)
+            {
+                phase = roundPhases[phaseIndex];
+                pool.Run(*this);
+            }
+        }
+        phase = MARK_INCOMING;
+        pool.Run(*this);
+        int vertexCount = graph.GetVertexCount();
+        vector<int> componentOfLabel(vertexCount, NO_LABEL);
+        vector<int> componentIndex(vertexCount);
+        int componentsCount = 0;
+        stronglyConnectedComponentsReachabilityInfo.Init(vertexCount);
+        for (int vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+        {
+            int vertexLabel = label[vertexIndex].load(std::memory_order_relaxed);
+            if (NO_LABEL == componentOfLabel[vertexLabel])
+            {
+                componentOfLabel[vertexLabel] = componentsCount++;
+                stronglyConnectedComponentsReachabilityInfo.SetReachable(
+                    componentOfLabel[vertexLabel], 
+                    hasIncoming[vertexLabel].load(std::memory_order_relaxed));
+            }
+            componentIndex[vertexIndex] = componentOfLabel[vertexLabel];
+        }
+        stronglyConnectedComponentsReachabilityInfo.GetStronglyConnectedComponentsInfo().
+            SetComponentIndex(componentIndex);
+    }
+};
+
+void ComputeStronglyConnectedComponentsReachabilityParallel(
+    const DirectedGraph & incidenceMatrix,
+    int threadsCount,
+    StronglyConnectedComponentsReachabilityInfo & stronglyConnectedComponentsReachabilityInfo)
+{
+    DirectedGraph matrixTransponed = ReverseDirectedGraph(incidenceMatrix);
+    ThreadPool pool(threadsCount);
+    ParallelStronglyConnectedComponents parallelStronglyConnectedComponents(
+        incidenceMatrix, matrixTransponed, pool);
+    parallelStronglyConnectedComponents.Run(stronglyConnectedComponentsReachabilityInfo);
+}
+
+enum StronglyConnectedComponentsAlgorithm
+{
+    PEARCE,
+    KOSARAJU,
+    PARALLEL
+};
+
+const char * const STRONGLY_CONNECTED_COMPONENTS_ALGORITHM_NAMES[] = 
+    {"pearce", "kosaraju", "parallel"};
+
+// threadsCount is used by the parallel algorithm only; 0 means one per core
+void ComputeStronglyConnectedComponentsReachability(const DirectedGraph & incidenceMatrix,
+    StronglyConnectedComponentsAlgorithm algorithm,
+    int threadsCount,
+    StronglyConnectedComponentsReachabilityInfo & stronglyConnectedComponentsReachabilityInfo)
+{
+    if (KOSARAJU == algorithm)
+    {
+        ComputeStronglyConnectedComponentsReachabilityKosaraju(incidenceMatrix, 
+            stronglyConnectedComponentsReachabilityInfo);
+    }
+    else if (PARALLEL == algorithm)
+    {
+        if (threadsCount <= 0)
+        {
+            threadsCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        ComputeStronglyConnectedComponentsReachabilityParallel(incidenceMatrix, threadsCount,
+            stronglyConnectedComponentsReachabilityInfo);
+    }
+    else
+    {
+        ComputeStronglyConnectedComponentsReachabilityPearce(incidenceMatrix, 
+            stronglyConnectedComponentsReachabilityInfo);
+    }
+}
+
+int GetTeamSize(const StronglyConnectedComponentsReachabilityInfo & 
+    stronglyConnectedComponentsReachabilityInfo)
 {
-    vectorOfIntVectors stupidMatrix = BuildIncidenceMatrix(games, peopleNumber);
-    StronglyConnectedComponentsReachabilityInfo stronglyConnectedComponentsReachabilityInfo = 
-        ComputeStronglyConnectedComponentsReachability(stupidMatrix);
+    const StronglyConnectedComponentsInfo & stronglyConnectedComponentsInfo = 
+        stronglyConnectedComponentsReachabilityInfo.GetStronglyConnectedComponentsInfo();
+    int peopleNumber = stronglyConnectedComponentsInfo.GetComponentIndex().size();
     int minComponentWithoutEntry = peopleNumber;
     for (int componentCounter = 0; 
-        componentCounter < stronglyConnectedComponentsReachabilityInfo.
-        GetStronglyConnectedComponentsInfo().
-        GetStronglyConnectedComponents().size(); 
+        componentCounter < stronglyConnectedComponentsInfo.GetComponentsCount(); 
         ++componentCounter)
     {
-        if ( (minComponentWithoutEntry > (stronglyConnectedComponentsReachabilityInfo.
-            GetStronglyConnectedComponentsInfo().
-            GetStronglyConnectedComponents()[componentCounter]).size()) && 
-            (false == stronglyConnectedComponentsReachabilityInfo.
-            GetReachable()[componentCounter]))
+        if (minComponentWithoutEntry > 
+            stronglyConnectedComponentsInfo.GetComponentSize(componentCounter) && 
+            false == stronglyConnectedComponentsReachabilityInfo.GetReachable()[componentCounter])
         {
-            minComponentWithoutEntry = (stronglyConnectedComponentsReachabilityInfo.
-                                       GetStronglyConnectedComponentsInfo().
-                                       GetStronglyConnectedComponents()[componentCounter]).
-                                       size();
+            minComponentWithoutEntry = 
+                stronglyConnectedComponentsInfo.GetComponentSize(componentCounter);
         }
     }
     return peopleNumber - minComponentWithoutEntry + 1;
 }
 
-vector<Game> ReadGames(int gamesNumber)
+class CountingCondensationEdges
 {
-    vector<Game> games;
-    for (int gameCounter = 0; gameCounter < gamesNumber; ++gameCounter)
+    DirectedGraph & condensation;
+public:
+    explicit CountingCondensationEdges(DirectedGraph & condensation) :
+        condensation(condensation)
+    {
+    }
+    void operator()(int fromComponent, int) const
+    {
+        condensation.CountEdge(fromComponent);
+    }
+};
+
+class AddingCondensationEdges
+{
+    DirectedGraph & condensation;
+public:
+    explicit AddingCondensationEdges(DirectedGraph & condensation) :
+        condensation(condensation)
+    {
+    }
+    void operator()(int fromComponent, int toComponent) const
+    {
+        condensation.AddEdge(fromComponent, toComponent);
+    }
+};
+
+// Calls action once for every ordered pair of distinct components joined by
+// a win. members holds an edge from every component to each of its
+// vertices; lastSource remembers the last component that met each target.
+template <class Action>
+void ForEachCondensationEdge(const DirectedGraph & incidenceMatrix, 
+    const DirectedGraph & members,
+    const vector<int> & componentIndex,
+    Action action)
+{
+    vector<int> lastSource(members.GetVertexCount(), -1);
+    for (int component = 0; component < members.GetVertexCount(); ++component)
     {
-        Game game;
-        int winner, looser, gameResult;
-        cin >> winner >> looser >> gameResult;
-        game.gameResult = (GameResult)gameResult;
-        if (SECOND_WIN == gameResult)
+        for (int member = members.GetFirstEdge(component); 
+            member < members.GetLastEdge(component); 
+            ++member)
         {
-            swap(winner, looser);
-            game.gameResult = FIRST_WIN;
+            int vertex = members.GetEdgeTarget(member);
+            for (int edge = incidenceMatrix.GetFirstEdge(vertex); 
+                edge < incidenceMatrix.GetLastEdge(vertex); 
+                ++edge)
+            {
+                int target = componentIndex[incidenceMatrix.GetEdgeTarget(edge)];
+                if (target != component && lastSource[target] != component)
+                {
+                    lastSource[target] = component;
+                    action(component, target);
+                }
+            }
         }
-        game.winner = winner - 1;
-        game.looser = looser - 1;
-        games.push_back(game);
     }
-    return games;
 }
 
-int main()
+// The condensation has a vertex for every component and an edge for every
+// ordered pair of components joined by at least one win, so it has no cycles
+DirectedGraph BuildCondensation(const DirectedGraph & incidenceMatrix,
+    const StronglyConnectedComponentsInfo & stronglyConnectedComponentsInfo)
 {
-    int peopleNumber, gamesNumber;
-    cin >> peopleNumber >> gamesNumber;
-    vector<Game> games = ReadGames(gamesNumber);
-    cout << GetTeamSize(games, peopleNumber) << endl;
+    const vector<int> & componentIndex = stronglyConnectedComponentsInfo.GetComponentIndex();
+    int componentsCount = stronglyConnectedComponentsInfo.GetComponentsCount();
+    DirectedGraph members;
+    members.StartCounting(componentsCount);
+    for (size_t vertexIndex = 0; vertexIndex < componentIndex.size(); ++vertexIndex)
+    {
+        members.CountEdge(componentIndex[vertexIndex]);
+    }
+    members.StartFilling();
+    for (size_t vertexIndex = 0; vertexIndex < componentIndex.size(); ++vertexIndex)
+    {
+        members.AddEdge(componentIndex[vertexIndex], vertexIndex);
+    }
+    members.FinishFilling();
+    DirectedGraph condensation;
+    condensation.StartCounting(componentsCount);
+    ForEachCondensationEdge(incidenceMatrix, members, componentIndex, 
+        CountingCondensationEdges(condensation));
+    condensation.StartFilling();
+    ForEachCondensationEdge(incidenceMatrix, members, componentIndex, 
+        AddingCondensationEdges(condensation));
+    condensation.FinishFilling();
+    return condensation;
+}
+
+class EnteringSubtree
+{
+    vector<int> & subtreeStart;
+    int & visitIndex;
+public:
+    EnteringSubtree(vector<int> & subtreeStart, int & visitIndex) :
+        subtreeStart(subtreeStart), visitIndex(visitIndex)
+    {
+    }
+    void operator()(int vertexIndex) const
+    {
+        subtreeStart[vertexIndex] = visitIndex++;
+    }
+};
+
+class LeavingSubtree
+{
+    vector<int> & subtreeEnd;
+    vector<int> & timeOutOrdered;
+    const int & visitIndex;
+public:
+    LeavingSubtree(vector<int> & subtreeEnd, vector<int> & timeOutOrdered, 
+        const int & visitIndex) :
+        subtreeEnd(subtreeEnd), timeOutOrdered(timeOutOrdered), visitIndex(visitIndex)
+    {
+    }
+    void operator()(int vertexIndex) const
+    {
+        subtreeEnd[vertexIndex] = visitIndex;
+        timeOutOrdered.push_back(vertexIndex);
+    }
+};
+
+// Orders the hubs of the 2-hop labels: components with many edges on both
+// sides come first, since they lie on the most paths. Ties go in a scrambled
+// order, which keeps the labels of long paths logarithmic.
+class ComparingHubCandidates
+{
+    const vector<long long> & weight;
+    static unsigned int Scramble(int vertexIndex)
+    {
+        return static_cast<unsigned int>(vertexIndex) * 2654435761u;
+    }
+public:
+    explicit ComparingHubCandidates(const vector<long long> & weight) :
+        weight(weight)
+    {
+    }
+    bool operator()(int first, int second) const
+    {
+        return weight[first] != weight[second] ? weight[first] > weight[second] : 
+            Scramble(first) < Scramble(second);
+    }
+};
+
+const int TRANSITIVE_CLOSURE_MAX_COMPONENTS = 1 << 14;
+
+// Tells whether one component of a condensation reaches another; every
+// component reaches itself. A depth-first forest numbers the components in
+// topological order, and no component reaches one with a smaller number.
+// Up to closureComponentsLimit components the index is the transitive
+// closure: one bit row per component holding the columns from its own number
+// on, built from the last number back by or-ing the rows of the successors.
+// Larger condensations are first cut into chains, where each link leaves a
+// component with one successor and enters one with one predecessor; inside
+// a chain order decides, and between chains only the tail of one and the
+// head of the other matter. The chains get 2-hop labels (Cohen et al.)
+// built by pruned searches from one hub after another (Yano et al.): the
+// hubs a chain reaches and the hubs reaching it are chosen so that u reaches
+// v exactly when the hubs of u meet the hubs of v. Before the labels are
+// merged, the preorder intervals of the forest answer the pairs it joins.
+class CondensationReachabilityIndex
+{
+private:
+    vector<int> topologicalNumber;
+    int rowWords;
+    vector<unsigned long long> closure;
+    vector<long long> rowStart;
+    vector<int> subtreeStart;
+    vector<int> subtreeEnd;
+    vector<int> chainIndex;
+    vector<int> chainPosition;
+    // Hub ranks in increasing order
+    DirectedGraph reachedHubs;
+    DirectedGraph reachingHubs;
+
+    static bool HubsMeet(const vector<int> & firstHubs, const vector<int> & secondHubs)
+    {
+        size_t first = 0, second = 0;
+        while (first < firstHubs.size() && second < secondHubs.size())
+        {
+            if (firstHubs[first] == secondHubs[second])
+            {
+                return true;
+            }
+            if (firstHubs[first] < secondHubs[second])
+            {
+                ++first;
+            }
+            else
+            {
+                ++second;
+            }
+        }
+        return false;
+    }
+    static void StoreHubs(const vector<vector<int> > & hubs, DirectedGraph & storedHubs)
+    {
+        storedHubs.StartCounting(hubs.size());
+        for (size_t chain = 0; chain < hubs.size(); ++chain)
+        {
+            for (size_t hub = 0; hub < hubs[chain].size(); ++hub)
+            {
+                storedHubs.CountEdge(chain);
+            }
+        }
+        storedHubs.StartFilling();
+        for (size_t chain = 0; chain < hubs.size(); ++chain)
+        {
+            for (size_t hub = 0; hub < hubs[chain].size(); ++hub)
+            {
+                storedHubs.AddEdge(chain, hubs[chain][hub]);
+            }
+        }
+        storedHubs.FinishFilling();
+    }
+    void BuildTransitiveClosure(const DirectedGraph & condensation, 
+        const vector<int> & timeOutOrdered)
+    {
+        int componentsCount = condensation.GetVertexCount();
+        rowWords = (componentsCount + 63) / 64;
+        rowStart.resize(componentsCount + 1);
+        rowStart[0] = 0;
+        for (int number = 0; number < componentsCount; ++number)
+        {
+            rowStart[number + 1] = rowStart[number] + rowWords - number / 64;
+        }
+        closure.assign(rowStart[componentsCount], 0);
+        // Successors finish before their predecessors
+        for (int finished = 0; finished < componentsCount; ++finished)
+        {
+            int component = timeOutOrdered[finished];
+            int number = topologicalNumber[component];
+            unsigned long long * row = &closure[rowStart[number]] - number / 64;
+            row[number / 64] |= 1ULL << (number % 64);
+            for (int edge = condensation.GetFirstEdge(component); 
+                edge < condensation.GetLastEdge(component); 
+                ++edge)
+            {
+                int successorNumber = topologicalNumber[condensation.GetEdgeTarget(edge)];
+                const unsigned long long * successorRow = 
+                    &closure[rowStart[successorNumber]] - successorNumber / 64;
+                for (int word = successorNumber / 64; word < rowWords; ++word)
+                {
+                    row[word] |= successorRow[word];
+                }
+            }
+        }
+    }
+    // Returns the graph of the chains: the edges leaving the tail of each
+    // chain, which always lead to heads of other chains
+    DirectedGraph BuildChains(const DirectedGraph & condensation, 
+        const DirectedGraph & reversedCondensation)
+    {
+        int componentsCount = condensation.GetVertexCount();
+        chainIndex.assign(componentsCount, -1);
+        chainPosition.assign(componentsCount, 0);
+        vector<int> tails;
+        for (int head = 0; head < componentsCount; ++head)
+        {
+            if (1 == reversedCondensation.GetLastEdge(head) - 
+                     reversedCondensation.GetFirstEdge(head))
+            {
+                int predecessor = reversedCondensation.GetEdgeTarget(
+                    reversedCondensation.GetFirstEdge(head));
+                if (1 == condensation.GetLastEdge(predecessor) - 
+                         condensation.GetFirstEdge(predecessor))
+                {
+                    continue;
+                }
+            }
+            int component = head;
+            chainIndex[component] = tails.size();
+            while (1 == condensation.GetLastEdge(component) - 
+                        condensation.GetFirstEdge(component))
+            {
+                int successor = condensation.GetEdgeTarget(condensation.GetFirstEdge(component));
+                if (1 != reversedCondensation.GetLastEdge(successor) - 
+                         reversedCondensation.GetFirstEdge(successor))
+                {
+                    break;
+                }
+                chainIndex[successor] = tails.size();
+                chainPosition[successor] = chainPosition[component] + 1;
+                component = successor;
+            }
+            tails.push_back(component);
+        }
+        DirectedGraph chains;
+        chains.StartCounting(tails.size());
+        for (size_t chain = 0; chain < tails.size(); ++chain)
+        {
+            for (int edge = condensation.GetFirstEdge(tails[chain]); 
+                edge < condensation.GetLastEdge(tails[chain]); 
+                ++edge)
+            {
+                chains.CountEdge(chain);
+            }
+        }
+        chains.StartFilling();
+        for (size_t chain = 0; chain < tails.size(); ++chain)
+        {
+            for (int edge = condensation.GetFirstEdge(tails[chain]); 
+                edge < condensation.GetLastEdge(tails[chain]); 
+                ++edge)
+            {
+                chains.AddEdge(chain, chainIndex[condensation.GetEdgeTarget(edge)]);
+            }
+        }
+        chains.FinishFilling();
+        return chains;
+    }
+    // A search from the hub stops at the chains it is already known to
+    // reach through an earlier hub; the others get the hub as a label
+    void BuildLabels(const DirectedGraph & chains)
+    {
+        int chainsCount = chains.GetVertexCount();
+        DirectedGraph reversedChains = ReverseDirectedGraph(chains);
+        vector<long long> weight(chainsCount);
+        vector<int> hubs(chainsCount);
+        for (int chain = 0; chain < chainsCount; ++chain)
+        {
+            weight[chain] = (chains.GetLastEdge(chain) - chains.GetFirstEdge(chain) + 1LL) * 
+                (reversedChains.GetLastEdge(chain) - reversedChains.GetFirstEdge(chain) + 1LL);
+            hubs[chain] = chain;
+        }
+        std::sort(hubs.begin(), hubs.end(), ComparingHubCandidates(weight));
+        vector<vector<int> > reached(chainsCount);
+        vector<vector<int> > reaching(chainsCount);
+        vector<int> visited(chainsCount, -1);
+        vector<int> queue;
+        queue.reserve(chainsCount);
+        for (int rank = 0; rank < chainsCount; ++rank)
+        {
+            int hub = hubs[rank];
+            queue.assign(1, hub);
+            visited[hub] = 2 * rank;
+            for (size_t queued = 0; queued < queue.size(); ++queued)
+            {
+                int chain = queue[queued];
+                if (chain != hub && HubsMeet(reached[hub], reaching[chain]))
+                {
+                    continue;
+                }
+                reaching[chain].push_back(rank);
+                for (int edge = chains.GetFirstEdge(chain); 
+                    edge < chains.GetLastEdge(chain); 
+                    ++edge)
+                {
+                    int target = chains.GetEdgeTarget(edge);
+                    if (visited[target] != 2 * rank)
+                    {
+                        visited[target] = 2 * rank;
+                        queue.push_back(target);
+                    }
+                }
+            }
+            queue.assign(1, hub);
+            visited[hub] = 2 * rank + 1;
+            for (size_t queued = 0; queued < queue.size(); ++queued)
+            {
+                int chain = queue[queued];
+                if (chain != hub && HubsMeet(reached[chain], reaching[hub]))
+                {
+                    continue;
+                }
+                reached[chain].push_back(rank);
+                for (int edge = reversedChains.GetFirstEdge(chain); 
+                    edge < reversedChains.GetLastEdge(chain); 
+                    ++edge)
+                {
+                    int target = reversedChains.GetEdgeTarget(edge);
+                    if (visited[target] != 2 * rank + 1)
+                    {
+                        visited[target] = 2 * rank + 1;
+                        queue.push_back(target);
+                    }
+                }
+            }
+        }
+        StoreHubs(reached, reachedHubs);
+        StoreHubs(reaching, reachingHubs);
+    }
+    bool LabelsMeet(int fromChain, int toChain) const
+    {
+        int first = reachedHubs.GetFirstEdge(fromChain);
+        int second = reachingHubs.GetFirstEdge(toChain);
+        while (first < reachedHubs.GetLastEdge(fromChain) && 
+               second < reachingHubs.GetLastEdge(toChain))
+        {
+            int firstHub = reachedHubs.GetEdgeTarget(first);
+            int secondHub = reachingHubs.GetEdgeTarget(second);
+            if (firstHub == secondHub)
+            {
+                return true;
+            }
+            if (firstHub < secondHub)
+            {
+                ++first;
+            }
+            else
+            {
+                ++second;
+            }
+        }
+        return false;
+    }
+public:
+    CondensationReachabilityIndex() : rowWords(0)
+    {
+    }
+    void Build(const DirectedGraph & condensation, int closureComponentsLimit)
+    {
+        int componentsCount = condensation.GetVertexCount();
+        vector<int> timeOutOrdered;
+        timeOutOrdered.reserve(componentsCount);
+        subtreeStart.assign(componentsCount, 0);
+        subtreeEnd.assign(componentsCount, 0);
+        vector<int> color(componentsCount, WHITE);
+        vector<DFSFrame> path;
+        int visitIndex = 0;
+        for (int component = 0; component < componentsCount; ++component)
+        {
+            if (WHITE == color[component])
+            {
+                DFSWithExtraActions(component, 
+                    color, 
+                    condensation, 
+                    EnteringSubtree(subtreeStart, visitIndex), 
+                    LeavingSubtree(subtreeEnd, timeOutOrdered, visitIndex), 
+                    path);
+            }
+        }
+        topologicalNumber.resize(componentsCount);
+        for (int finished = 0; finished < componentsCount; ++finished)
+        {
+            topologicalNumber[timeOutOrdered[finished]] = componentsCount - 1 - finished;
+        }
+        closure.clear();
+        rowStart.clear();
+        chainIndex.clear();
+        chainPosition.clear();
+        reachedHubs = DirectedGraph();
+        reachingHubs = DirectedGraph();
+        if (componentsCount <= closureComponentsLimit)
+        {
+            vector<int>().swap(subtreeStart);
+            vector<int>().swap(subtreeEnd);
+            BuildTransitiveClosure(condensation, timeOutOrdered);
+        }
+        else
+        {
+            BuildLabels(BuildChains(condensation, ReverseDirectedGraph(condensation)));
+        }
+    }
+    bool UsesTransitiveClosure() const
+    {
+        return !rowStart.empty();
+    }
+    bool IsReachable(int fromComponent, int toComponent) const
+    {
+        int fromNumber = topologicalNumber[fromComponent];
+        int toNumber = topologicalNumber[toComponent];
+        if (fromNumber > toNumber)
+        {
+            return false;
+        }
+        if (UsesTransitiveClosure())
+        {
+            return 0 != (closure[rowStart[fromNumber] + toNumber / 64 - fromNumber / 64] >> 
+                         (toNumber % 64) & 1);
+        }
+        if (subtreeStart[fromComponent] <= subtreeStart[toComponent] && 
+            subtreeStart[toComponent] < subtreeEnd[fromComponent])
+        {
+            return true;
+        }
+        if (chainIndex[fromComponent] == chainIndex[toComponent])
+        {
+            return chainPosition[fromComponent] <= chainPosition[toComponent];
+        }
+        return LabelsMeet(chainIndex[fromComponent], chainIndex[toComponent]);
+    }
+    int GetChainsCount() const
+    {
+        return reachedHubs.GetVertexCount();
+    }
+    long long GetLabelsCount() const
+    {
+        return static_cast<long long>(reachedHubs.GetEdgeCount()) + reachingHubs.GetEdgeCount();
+    }
+    long long GetMemoryBytes() const
+    {
+        return sizeof(int) * (topologicalNumber.size() + subtreeStart.size() + 
+                              subtreeEnd.size() + chainIndex.size() + chainPosition.size() + 
+                              reachedHubs.GetVertexCount() + 1 + reachedHubs.GetEdgeCount() + 
+                              reachingHubs.GetVertexCount() + 1 + reachingHubs.GetEdgeCount()) + 
+            sizeof(unsigned long long) * closure.size() + sizeof(long long) * rowStart.size();
+    }
+};
+
+struct ReachabilityQuery
+{
+    int from;
+    int to;
+};
+
+// answers[query] tells whether the player from can beat the player to
+// through a chain of wins; a player counts as beating themselves
+void AnswerReachabilityQueries(const StronglyConnectedComponentsInfo & 
+    stronglyConnectedComponentsInfo,
+    const CondensationReachabilityIndex & condensationReachabilityIndex,
+    const vector<ReachabilityQuery> & queries,
+    vector<bool> & answers)
+{
+    const vector<int> & componentIndex = stronglyConnectedComponentsInfo.GetComponentIndex();
+    answers.resize(queries.size());
+    for (size_t query = 0; query < queries.size(); ++query)
+    {
+        answers[query] = condensationReachabilityIndex.IsReachable(
+            componentIndex[queries[query].from], componentIndex[queries[query].to]);
+    }
+}
+
+const int ORDER_LABEL_BITS = 62;
+const unsigned long long ORDER_LABEL_LIMIT = 1ULL << ORDER_LABEL_BITS;
+
+// A list whose items carry increasing labels, so that the order of two items
+// is a comparison of labels. An item inserted between two labels that are
+// adjacent makes the smallest aligned label range around it that is sparse
+// enough relabel evenly (Bender et al.); a range of 2^bits labels is sparse
+// enough while it holds fewer than (4/3)^bits items.
+class OrderedList
+{
+private:
+    vector<unsigned long long> label;
+    vector<int> previous;
+    vector<int> next;
+    int end;
+
+    OrderedList(const OrderedList &);
+    OrderedList & operator=(const OrderedList &);
+
+    void Relabel(int item, unsigned long long base)
+    {
+        int first = item;
+        int last = item;
+        int count = 1;
+        for (int bits = 1; ; ++bits)
+        {
+            unsigned long long rangeSize = 1ULL << bits;
+            unsigned long long rangeStart = base & ~(rangeSize - 1);
+            while (end != previous[first] && label[previous[first]] >= rangeStart)
+            {
+                first = previous[first];
+                ++count;
+            }
+            while (end != next[last] && label[next[last]] - rangeStart < rangeSize)
+            {
+                last = next[last];
+                ++count;
+            }
+            if (ORDER_LABEL_BITS == bits || count < pow(4.0 / 3.0, bits))
+            {
+                unsigned long long gap = rangeSize / (count + 1);
+                unsigned long long current = rangeStart;
+                for (int relabelled = first; ; relabelled = next[relabelled])
+                {
+                    current += gap;
+                    label[relabelled] = current;
+                    if (relabelled == last)
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+public:
+    // Items 0 .. size - 1 in this order
+    explicit OrderedList(int size) :
+    label(size + 1), previous(size + 1), next(size + 1), end(size)
+    {
+        for (int item = 0; item <= size; ++item)
+        {
+            label[item] = (ORDER_LABEL_LIMIT / (size + 1)) * (item + 1);
+            previous[item] = (item + size) % (size + 1);
+            next[item] = (item + 1) % (size + 1);
+        }
+    }
+
+    // Stands for the end of the list; inserting before it appends
+    int GetEnd() const
+    {
+        return end;
+    }
+
+    unsigned long long GetLabel(int item) const
+    {
+        return label[item];
+    }
+
+    void Remove(int item)
+    {
+        next[previous[item]] = next[item];
+        previous[next[item]] = previous[item];
+    }
+
+    void InsertAfter(int anchor, int item)
+    {
+        previous[item] = anchor;
+        next[item] = next[anchor];
+        previous[next[item]] = item;
+        next[anchor] = item;
+        unsigned long long lower = end == anchor ? 0 : label[anchor];
+        unsigned long long upper = end == next[item] ? ORDER_LABEL_LIMIT : label[next[item]];
+        if (upper - lower >= 2)
+        {
+            label[item] = lower + (upper - lower) / 2;
+        }
+        else
+        {
+            Relabel(item, lower);
+        }
+    }
+
+    void InsertBefore(int anchor, int item)
+    {
+        InsertAfter(previous[anchor], item);
+    }
+};
+
+// Keeps the components of a graph that only gains edges, so the team size
+// is known after every game. Components are union-find sets kept in
+// topological order with the two-way search of Haeupler, Kavitha, Mathew,
+// Sen and Tarjan; a cycle found by the search is merged into one component.
+// Every component counts its incoming edges from other components, and the
+// sources are counted by size.
+class IncrementalStronglyConnectedComponents
+{
+private:
+    typedef std::pair<unsigned long long, int> LabelledComponent;
+
+    int peopleNumber;
+    vector<int> parent;
+    vector<int> componentSize;
+    vector<int> inCount;
+    vector<vector<int> > outEdges;
+    vector<vector<int> > inEdges;
+    OrderedList order;
+    vector<int> forwardMark;
+    vector<int> backwardMark;
+    vector<int> mergeMark;
+    vector<int> forwardCursor;
+    vector<int> backwardCursor;
+    int searchStamp;
+    // Sources of every size; the smallest size never decreases, since a
+    // merged source contains the component that came first in its cycle
+    vector<int> sourcesOfSize;
+    int minSourceSize;
+    int componentsCount;
+    std::priority_queue<LabelledComponent, vector<LabelledComponent>, 
+                        std::greater<LabelledComponent> > forwardQueue;
+    std::priority_queue<LabelledComponent> backwardQueue;
+    vector<int> forwardComponents;
+    vector<int> backwardComponents;
+    vector<int> backwardMoved;
+    vector<int> forwardMoved;
+    vector<int> mergeComponents;
+
+    class CompareByOrder
+    {
+        const OrderedList & order;
+    public:
+        explicit CompareByOrder(const OrderedList & order) : order(order)
+        {
+        }
+        bool operator()(int first, int second) const
+        {
+            return order.GetLabel(first) < order.GetLabel(second);
+        }
+    };
+
+    int Find(int vertexIndex)
+    {
+        int root = vertexIndex;
+        while (parent[root] != root)
+        {
+            root = parent[root];
+        }
+        while (parent[vertexIndex] != root)
+        {
+            int next = parent[vertexIndex];
+            parent[vertexIndex] = root;
+            vertexIndex = next;
+        }
+        return root;
+    }
+
+    void AddSource(int size)
+    {
+        ++sourcesOfSize[size];
+        minSourceSize = std::min(minSourceSize, size);
+    }
+
+    void RemoveSource(int size)
+    {
+        --sourcesOfSize[size];
+        while (minSourceSize <= peopleNumber && 0 == sourcesOfSize[minSourceSize])
+        {
+            ++minSourceSize;
+        }
+    }
+
+    void Visit(int component, bool forward)
+    {
+        if (forward)
+        {
+            forwardMark[component] = searchStamp;
+            forwardCursor[component] = 0;
+            forwardQueue.push(LabelledComponent(order.GetLabel(component), component));
+            forwardComponents.push_back(component);
+        }
+        else
+        {
+            backwardMark[component] = searchStamp;
+            backwardCursor[component] = 0;
+            backwardQueue.push(LabelledComponent(order.GetLabel(component), component));
+            backwardComponents.push_back(component);
+        }
+    }
+
+    // Edges that a merge made internal are dropped when met
+    bool NextNeighbour(int component, bool forward, int & neighbour)
+    {
+        vector<int> & edges = forward ? outEdges[component] : inEdges[component];
+        int & cursor = forward ? forwardCursor[component] : backwardCursor[component];
+        while (cursor < static_cast<int>(edges.size()))
+        {
+            neighbour = Find(edges[cursor]);
+            if (neighbour != component)
+            {
+                ++cursor;
+                return true;
+            }
+            edges[cursor] = edges.back();
+            edges.pop_back();
+        }
+        return false;
+    }
+
+    // Scans one edge of the closest unfinished component of a search; true
+    // if the edge leads to a component the other search has found
+    bool SearchStep(bool forward)
+    {
+        int component = forward ? forwardQueue.top().second : backwardQueue.top().second;
+        int neighbour = 0;
+        if (!NextNeighbour(component, forward, neighbour))
+        {
+            if (forward)
+            {
+                forwardQueue.pop();
+            }
+            else
+            {
+                backwardQueue.pop();
+            }
+            return false;
+        }
+        if (searchStamp != (forward ? forwardMark : backwardMark)[neighbour])
+        {
+            Visit(neighbour, forward);
+        }
+        return searchStamp == (forward ? backwardMark : forwardMark)[neighbour];
+    }
+
+    // Collects the finished components of a search on the far side of a
+    // frontier, in order and without the merged ones
+    void CollectMoved(const vector<int> & found, bool forward, unsigned long long frontier, 
+        vector<int> & moved)
+    {
+        moved.clear();
+        for (size_t counter = 0; counter < found.size(); ++counter)
+        {
+            int component = found[counter];
+            unsigned long long label = order.GetLabel(component);
+            if ((forward ? label < frontier : label > frontier) && 
+                searchStamp != mergeMark[component])
+            {
+                moved.push_back(component);
+            }
+        }
+        std::sort(moved.begin(), moved.end(), CompareByOrder(order));
+    }
+
+    // Merges the components of mergeComponents into the one with the longest
+    // edge lists and returns it
+    int MergeComponents()
+    {
+        int largest = mergeComponents[0];
+        int incomingEdges = 0;
+        for (size_t counter = 0; counter < mergeComponents.size(); ++counter)
+        {
+            int component = mergeComponents[counter];
+            if (outEdges[component].size() + inEdges[component].size() > 
+                outEdges[largest].size() + inEdges[largest].size())
+            {
+                largest = component;
+            }
+            if (0 == inCount[component])
+            {
+                RemoveSource(componentSize[component]);
+            }
+            incomingEdges += inCount[component];
+        }
+        // Edges between the merged components stop counting as incoming;
+        // each one is seen in the lists of a component other than largest
+        for (size_t counter = 0; counter < mergeComponents.size(); ++counter)
+        {
+            int component = mergeComponents[counter];
+            if (component == largest)
+            {
+                continue;
+            }
+            for (size_t edgeCounter = 0; edgeCounter < inEdges[component].size(); ++edgeCounter)
+            {
+                int source = Find(inEdges[component][edgeCounter]);
+                if (source != component && searchStamp == mergeMark[source])
+                {
+                    --incomingEdges;
+                }
+            }
+            for (size_t edgeCounter = 0; edgeCounter < outEdges[component].size(); ++edgeCounter)
+            {
+                if (largest == Find(outEdges[component][edgeCounter]))
+                {
+                    --incomingEdges;
+                }
+            }
+        }
+        for (size_t counter = 0; counter < mergeComponents.size(); ++counter)
+        {
+            int component = mergeComponents[counter];
+            if (component == largest)
+            {
+                continue;
+            }
+            parent[component] = largest;
+            componentSize[largest] += componentSize[component];
+            outEdges[largest].insert(outEdges[largest].end(), 
+                                     outEdges[component].begin(), outEdges[component].end());
+            inEdges[largest].insert(inEdges[largest].end(), 
+                                    inEdges[component].begin(), inEdges[component].end());
+            vector<int>().swap(outEdges[component]);
+            vector<int>().swap(inEdges[component]);
+            --componentsCount;
+        }
+        inCount[largest] = incomingEdges;
+        if (0 == incomingEdges)
+        {
+            AddSource(componentSize[largest]);
+        }
+        return largest;
+    }
+
+    // Marks the components on a cycle through the new edge, that is those
+    // found forward that reach a component found backward and those found
+    // backward that are reached from one found forward. Every such component
+    // is found by a search that has finished it or by both, so the edges
+    // the searches scanned settle the question.
+    void MarkCycle(unsigned long long forwardFrontier, unsigned long long backwardFrontier)
+    {
+        mergeComponents.clear();
+        std::sort(forwardComponents.begin(), forwardComponents.end(), CompareByOrder(order));
+        for (int counter = forwardComponents.size() - 1; counter >= 0; --counter)
+        {
+            int component = forwardComponents[counter];
+            bool inCycle = searchStamp == backwardMark[component];
+            const vector<int> & edges = outEdges[component];
+            for (size_t edgeCounter = 0; 
+                !inCycle && order.GetLabel(component) < forwardFrontier && 
+                edgeCounter < edges.size(); 
+                ++edgeCounter)
+            {
+                int target = Find(edges[edgeCounter]);
+                inCycle = searchStamp == backwardMark[target] || searchStamp == mergeMark[target];
+            }
+            if (inCycle)
+            {
+                mergeMark[component] = searchStamp;
+                mergeComponents.push_back(component);
+            }
+        }
+        std::sort(backwardComponents.begin(), backwardComponents.end(), CompareByOrder(order));
+        for (size_t counter = 0; counter < backwardComponents.size(); ++counter)
+        {
+            int component = backwardComponents[counter];
+            if (searchStamp == forwardMark[component] || 
+                order.GetLabel(component) <= backwardFrontier)
+            {
+                continue;
+            }
+            const vector<int> & edges = inEdges[component];
+            for (size_t edgeCounter = 0; edgeCounter < edges.size(); ++edgeCounter)
+            {
+                int source = Find(edges[edgeCounter]);
+                if (searchStamp == forwardMark[source] || searchStamp == mergeMark[source])
+                {
+                    mergeMark[component] = searchStamp;
+                    mergeComponents.push_back(component);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Searches from both ends of an edge against the order until their
+    // frontiers pass each other. The finished components found backward
+    // beyond the forward frontier, then the merged cycle if the searches
+    // met, then the finished components found forward before the frontier
+    // are moved just before the first unfinished forward component.
+    void Restore(int source, int target)
+    {
+        ++searchStamp;
+        while (!forwardQueue.empty())
+        {
+            forwardQueue.pop();
+        }
+        while (!backwardQueue.empty())
+        {
+            backwardQueue.pop();
+        }
+        forwardComponents.clear();
+        backwardComponents.clear();
+        Visit(target, true);
+        Visit(source, false);
+        bool cycle = false;
+        while (!forwardQueue.empty() && !backwardQueue.empty() && 
+               forwardQueue.top().first < backwardQueue.top().first)
+        {
+            cycle = SearchStep(true) || cycle;
+            cycle = SearchStep(false) || cycle;
+        }
+        unsigned long long forwardFrontier = forwardQueue.empty() ? 
+            ORDER_LABEL_LIMIT : forwardQueue.top().first;
+        unsigned long long backwardFrontier = backwardQueue.empty() ? 
+            0 : backwardQueue.top().first;
+        int anchor = forwardQueue.empty() ? order.GetEnd() : forwardQueue.top().second;
+        int merged = -1;
+        if (cycle)
+        {
+            MarkCycle(forwardFrontier, backwardFrontier);
+        }
+        CollectMoved(backwardComponents, false, forwardFrontier, backwardMoved);
+        CollectMoved(forwardComponents, true, forwardFrontier, forwardMoved);
+        if (cycle)
+        {
+            for (size_t counter = 0; counter < mergeComponents.size(); ++counter)
+            {
+                if (mergeComponents[counter] != anchor)
+                {
+                    order.Remove(mergeComponents[counter]);
+                }
+            }
+            merged = MergeComponents();
+        }
+        for (size_t counter = 0; counter < backwardMoved.size(); ++counter)
+        {
+            order.Remove(backwardMoved[counter]);
+            order.InsertBefore(anchor, backwardMoved[counter]);
+        }
+        if (merged == anchor)
+        {
+            for (int counter = forwardMoved.size() - 1; counter >= 0; --counter)
+            {
+                order.Remove(forwardMoved[counter]);
+                order.InsertAfter(anchor, forwardMoved[counter]);
+            }
+            return;
+        }
+        if (-1 != merged)
+        {
+            order.InsertBefore(anchor, merged);
+        }
+        for (size_t counter = 0; counter < forwardMoved.size(); ++counter)
+        {
+            order.Remove(forwardMoved[counter]);
+            order.InsertBefore(anchor, forwardMoved[counter]);
+        }
+        if (cycle && order.GetEnd() != anchor && searchStamp == mergeMark[anchor])
+        {
+            order.Remove(anchor);
+        }
+    }
+
+public:
+    explicit IncrementalStronglyConnectedComponents(int peopleNumber) :
+    peopleNumber(peopleNumber), parent(peopleNumber), componentSize(peopleNumber, 1),
+    inCount(peopleNumber, 0), outEdges(peopleNumber), inEdges(peopleNumber), 
+    order(peopleNumber), forwardMark(peopleNumber, 0), backwardMark(peopleNumber, 0), 
+    mergeMark(peopleNumber, 0), forwardCursor(peopleNumber, 0), 
+    backwardCursor(peopleNumber, 0), searchStamp(0), sourcesOfSize(peopleNumber + 1, 0), 
+    minSourceSize(peopleNumber + 1), componentsCount(peopleNumber)
+    {
+        for (int vertexIndex = 0; vertexIndex < peopleNumber; ++vertexIndex)
+        {
+            parent[vertexIndex] = vertexIndex;
+            AddSource(1);
+        }
+    }
+
+    void AddEdge(int from, int to)
+    {
+        int source = Find(from);
+        int target = Find(to);
+        if (source == target)
+        {
+            return;
+        }
+        outEdges[source].push_back(to);
+        inEdges[target].push_back(from);
+        if (0 == inCount[target]++)
+        {
+            RemoveSource(componentSize[target]);
+        }
+        if (order.GetLabel(source) > order.GetLabel(target))
+        {
+            Restore(source, target);
+        }
+    }
+
+    void AddGame(const Game & game)
+    {
+        if (DRAW != game.gameResult)
+        {
+            AddEdge(game.winner, game.looser);
+        }
+    }
+
+    int GetComponentsCount() const
+    {
+        return componentsCount;
+    }
+
+    int GetTeamSize() const
+    {
+        return peopleNumber - std::min(minSourceSize, peopleNumber) + 1;
+    }
+};
+
+const int OUTPUT_BUFFER_SIZE = 1 << 16;
+const int INPUT_READ_SIZE = 1 << 16;
+
+// Maps the input when it is a regular file and otherwise reads it through
+// a window of INPUT_READ_SIZE bytes, so a pipe costs no more memory than
+// the window; integers are parsed straight from memory
+class FastInput
+{
+private:
+    FILE * file;
+    char * mapping;
+    size_t mappingSize;
+    vector<char> buffer;
+    const char * position;
+    const char * end;
+
+    FastInput(const FastInput &);
+    FastInput & operator=(const FastInput &);
+
+    static bool IsDigit(char symbol)
+    {
+        return static_cast<unsigned char>(symbol - '0') < 10;
+    }
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // Every byte of the block is a digit
+    static bool AreEightDigits(unsigned long long block)
+    {
+        unsigned long long highNibbles = block & 0xF0F0F0F0F0F0F0F0ULL;
+        unsigned long long shiftedHighNibbles = 
+            (block + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL;
+        return 0x3333333333333333ULL == (highNibbles | (shiftedHighNibbles >> 4));
+    }
+
+    // Combines digits pairwise, then pairs of pairs, without a loop
+    static unsigned long long ParseEightDigits(unsigned long long block)
+    {
+        block -= 0x3030303030303030ULL;
+        block = block * 10 + (block >> 8);
+        return ((block & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)) +
+                ((block >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32))) >> 32;
+    }
+#endif
+
+    // Moves the unread bytes to the front of the window and reads more after
+    // them; false if nothing more could be read
+    bool Refill()
+    {
+        if (NULL == file)
+        {
+            return false;
+        }
+        size_t unread = end - position;
+        memmove(&buffer[0], position, unread);
+        size_t read = fread(&buffer[unread], 1, buffer.size() - unread, file);
+        position = &buffer[0];
+        end = position + unread + read;
+        return read > 0;
+    }
+
+public:
+    explicit FastInput(FILE * inputFile) : file(NULL), mapping(NULL), mappingSize(0)
+    {
+        int descriptor = fileno(inputFile);
+        struct stat fileStat;
+        off_t offset = lseek(descriptor, 0, SEEK_CUR);
+        if (0 == fstat(descriptor, &fileStat) && S_ISREG(fileStat.st_mode) && 
+            offset >= 0 && fileStat.st_size > offset)
+        {
+            void * fileMapping = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, 
+                                      descriptor, 0);
+            if (MAP_FAILED != fileMapping)
+            {
+                mapping = static_cast<char *>(fileMapping);
+                mappingSize = fileStat.st_size;
+                madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+                position = mapping + offset;
+                end = mapping + mappingSize;
+                return;
+            }
+        }
+        file = inputFile;
+        buffer.resize(INPUT_READ_SIZE);
+        position = &buffer[0];
+        end = position;
+    }
+
+    ~FastInput()
+    {
+        if (NULL != mapping)
+        {
+            munmap(mapping, mappingSize);
+        }
+    }
+
+    // Skips to the next integer and parses it; false at the end of the input
+    template <class Integer>
+    bool Read(Integer & value)
+    {
+        for (;;)
+        {
+            while (position != end && '-' != *position && !IsDigit(*position))
+            {
+                ++position;
+            }
+            if (position != end)
+            {
+                break;
+            }
+            if (!Refill())
+            {
+                return false;
+            }
+        }
+        bool negative = '-' == *position;
+        if (negative)
+        {
+            ++position;
+        }
+        unsigned long long result = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        unsigned long long block;
+        while (end - position >= 8 && 
+               (memcpy(&block, position, 8), AreEightDigits(block)))
+        {
+            result = result * 100000000 + ParseEightDigits(block);
+            position += 8;
+        }
+#endif
+        do
+        {
+            while (position != end && IsDigit(*position))
+            {
+                result = result * 10 + (*position - '0');
+                ++position;
+            }
+        } while (position == end && Refill());
+        value = negative ? 0 - result : result;
+        return true;
+    }
+};
+
+// Formats numbers into a fixed buffer and writes it out in large blocks
+class BufferedWriter
+{
+private:
+    FILE * output;
+    vector<char> buffer;
+    size_t filled;
+
+    BufferedWriter(const BufferedWriter &);
+    BufferedWriter & operator=(const BufferedWriter &);
+
+public:
+    explicit BufferedWriter(FILE * output) :
+    output(output), buffer(OUTPUT_BUFFER_SIZE), filled(0)
+    {
+    }
+
+    ~BufferedWriter()
+    {
+        Flush();
+    }
+
+    void Flush()
+    {
+        if (filled > 0)
+        {
+            fwrite(&buffer[0], 1, filled, output);
+            filled = 0;
+        }
+        fflush(output);
+    }
+
+    void WriteChar(char symbol)
+    {
+        if (filled == buffer.size())
+        {
+            Flush();
+        }
+        buffer[filled++] = symbol;
+    }
+
+    void WriteNumber(long long number)
+    {
+        char digits[24];
+        int digitsCount = 0;
+        unsigned long long absoluteValue = number < 0 ? 
+            0ULL - static_cast<unsigned long long>(number) : number;
+        do
+        {
+            digits[digitsCount++] = '0' + absoluteValue % 10;
+            absoluteValue /= 10;
+        } while (absoluteValue > 0);
+        if (filled + digitsCount + 1 > buffer.size())
+        {
+            Flush();
+        }
+        if (number < 0)
+        {
+            buffer[filled++] = '-';
+        }
+        while (digitsCount > 0)
+        {
+            buffer[filled++] = digits[--digitsCount];
+        }
+    }
+};
+
+Game ReadGame(FastInput & input)
+{
+    Game game;
+    int winner = 0, looser = 0, gameResult = 0;
+    input.Read(winner);
+    input.Read(looser);
+    input.Read(gameResult);
+    game.gameResult = (GameResult)gameResult;
+    if (SECOND_WIN == gameResult)
+    {
+        swap(winner, looser);
+        game.gameResult = FIRST_WIN;
+    }
+    game.winner = winner - 1;
+    game.looser = looser - 1;
+    return game;
+}
+
+vector<Game> ReadGames(FastInput & input, int gamesNumber)
+{
+    vector<Game> games;
+    games.reserve(gamesNumber);
+    for (int gameCounter = 0; gameCounter < gamesNumber; ++gameCounter)
+    {
+        games.push_back(ReadGame(input));
+    }
+    return games;
+}
+
+// Prints the team size after every game
+void FollowTeamSize(FastInput & input, int peopleNumber, int gamesNumber, 
+    BufferedWriter & writer)
+{
+    IncrementalStronglyConnectedComponents components(peopleNumber);
+    for (int gameCounter = 0; gameCounter < gamesNumber; ++gameCounter)
+    {
+        components.AddGame(ReadGame(input));
+        writer.WriteNumber(components.GetTeamSize());
+        writer.WriteChar('\n');
+    }
+}
+
+// Feeds the games one by one, asking for the team size after each, and
+// checks the final answer against Pearce's algorithm on the whole graph
+bool BenchmarkIncrementalStronglyConnectedComponents(const vector<Game> & games, 
+    int peopleNumber)
+{
+    struct timespec start, finish;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    IncrementalStronglyConnectedComponents components(peopleNumber);
+    long long teamSizesSum = 0;
+    for (size_t gameCounter = 0; gameCounter < games.size(); ++gameCounter)
+    {
+        components.AddGame(games[gameCounter]);
+        teamSizesSum += components.GetTeamSize();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    double seconds = (finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec) * 1e-9;
+    StronglyConnectedComponentsReachabilityInfo stronglyConnectedComponentsReachabilityInfo;
+    ComputeStronglyConnectedComponentsReachability(BuildIncidenceMatrix(games, peopleNumber), 
+        PEARCE, 1, stronglyConnectedComponentsReachabilityInfo);
+    int expectedTeamSize = GetTeamSize(stronglyConnectedComponentsReachabilityInfo);
+    printf("{\"games\": %d, \"seconds\": %.6f, \"games_per_second\": %.0f, "
+           "\"components\": %d, \"team_size\": %d, \"team_sizes_sum\": %lld}\n",
+           static_cast<int>(games.size()), seconds, 
+           seconds > 0 ? games.size() / seconds : 0.0,
+           components.GetComponentsCount(), components.GetTeamSize(), teamSizesSum);
+    fflush(stdout);
+    if (expectedTeamSize != components.GetTeamSize() || 
+        stronglyConnectedComponentsReachabilityInfo.GetStronglyConnectedComponentsInfo().
+        GetComponentsCount() != components.GetComponentsCount())
+    {
+        fprintf(stderr, "the incremental components disagree with Pearce's algorithm\n");
+        return false;
+    }
+    return true;
+}
+
+struct AlgorithmMeasurement
+{
+    double seconds;
+    int teamSize;
+    unsigned long long partitionHash;
+};
+
+// Hashes the smallest member of the component of every vertex, which does
+// not depend on how an algorithm numbers the components
+unsigned long long HashPartition(const StronglyConnectedComponentsInfo & 
+    stronglyConnectedComponentsInfo)
+{
+    const vector<int> & componentIndex = stronglyConnectedComponentsInfo.GetComponentIndex();
+    vector<int> smallestMember(stronglyConnectedComponentsInfo.GetComponentsCount(), INT_MAX);
+    unsigned long long hash = 14695981039346656037ULL;
+    int verticesCount = componentIndex.size();
+    for (int vertexIndex = 0; vertexIndex < verticesCount; ++vertexIndex)
+    {
+        int & member = smallestMember[componentIndex[vertexIndex]];
+        member = std::min(member, vertexIndex);
+        hash = (hash ^ static_cast<unsigned int>(member)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+struct BenchmarkRun
+{
+    StronglyConnectedComponentsAlgorithm algorithm;
+    int threadsCount;
+};
+
+// Runs every algorithm in a child process of its own, so that the peak
+// resident set size of each one can be told apart. The peak of a child
+// includes the graph it inherits; reading the input peaks in the parent.
+// The parallel algorithm runs with 1, 2, 4, ... up to maxThreadsCount threads.
+// Prints the measurements as JSON and fails if the partitions or the team
+// sizes differ.
+bool BenchmarkStronglyConnectedComponents(const DirectedGraph & incidenceMatrix, 
+    int maxThreadsCount)
+{
+    vector<BenchmarkRun> runs;
+    BenchmarkRun kosaraju = {KOSARAJU, 1};
+    BenchmarkRun pearce = {PEARCE, 1};
+    runs.push_back(kosaraju);
+    runs.push_back(pearce);
+    for (int threadsCount = 1; threadsCount < 2 * maxThreadsCount; threadsCount *= 2)
+    {
+        BenchmarkRun parallel = {PARALLEL, std::min(threadsCount, maxThreadsCount)};
+        runs.push_back(parallel);
+    }
+    struct rusage inputUsage;
+    getrusage(RUSAGE_SELF, &inputUsage);
+    AlgorithmMeasurement firstMeasurement = {0, 0, 0};
+    bool agree = true;
+    printf("[");
+    for (size_t runCounter = 0; runCounter < runs.size(); ++runCounter)
+    {
+        const BenchmarkRun & run = runs[runCounter];
+        int channel[2];
+        if (0 != pipe(channel))
+        {
+            perror("pipe");
+            return false;
+        }
+        fflush(stdout);
+        pid_t child = fork();
+        if (child < 0)
+        {
+            perror("fork");
+            return false;
+        }
+        if (0 == child)
+        {
+            close(channel[0]);
+            struct timespec start, finish;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            StronglyConnectedComponentsReachabilityInfo stronglyConnectedComponentsReachabilityInfo;
+            ComputeStronglyConnectedComponentsReachability(incidenceMatrix, 
+                run.algorithm, run.threadsCount, stronglyConnectedComponentsReachabilityInfo);
+            AlgorithmMeasurement measurement;
+            measurement.teamSize = GetTeamSize(stronglyConnectedComponentsReachabilityInfo);
+            clock_gettime(CLOCK_MONOTONIC, &finish);
+            measurement.seconds = (finish.tv_sec - start.tv_sec) + 
+                (finish.tv_nsec - start.tv_nsec) * 1e-9;
+            measurement.partitionHash = HashPartition(
+                stronglyConnectedComponentsReachabilityInfo.GetStronglyConnectedComponentsInfo());
+            ssize_t written = write(channel[1], &measurement, sizeof(measurement));
+            _exit(sizeof(measurement) == written ? 0 : 1);
+        }
+        close(channel[1]);
+        AlgorithmMeasurement measurement;
+        ssize_t received = read(channel[0], &measurement, sizeof(measurement));
+        close(channel[0]);
+        int status = 0;
+        struct rusage childUsage;
+        if (child != wait4(child, &status, 0, &childUsage) || 
+            !WIFEXITED(status) || 0 != WEXITSTATUS(status) || 
+            sizeof(measurement) != received)
+        {
+            fprintf(stderr, "%s failed\n", 
+                    STRONGLY_CONNECTED_COMPONENTS_ALGORITHM_NAMES[run.algorithm]);
+            return false;
+        }
+        printf("%s\n  {\"algorithm\": \"%s\", \"threads\": %d, \"vertices\": %d, "
+               "\"edges\": %d, \"seconds\": %.6f, \"input_peak_rss_kb\": %ld, "
+               "\"peak_rss_kb\": %ld, \"team_size\": %d, \"partition_hash\": \"%016llx\"}",
+               0 == runCounter ? "" : ",",
+               STRONGLY_CONNECTED_COMPONENTS_ALGORITHM_NAMES[run.algorithm],
+               run.threadsCount,
+               incidenceMatrix.GetVertexCount(), incidenceMatrix.GetEdgeCount(),
+               measurement.seconds, inputUsage.ru_maxrss, childUsage.ru_maxrss,
+               measurement.teamSize, measurement.partitionHash);
+        if (0 == runCounter)
+        {
+            firstMeasurement = measurement;
+        }
+        else if (firstMeasurement.teamSize != measurement.teamSize || 
+                 firstMeasurement.partitionHash != measurement.partitionHash)
+        {
+            agree = false;
+        }
+    }
+    printf("\n]\n");
+    fflush(stdout);
+    if (!agree)
+    {
+        fprintf(stderr, "the algorithms disagree on the components\n");
+    }
+    return agree;
+}
+
+// Reads the number of queries and the queries "a b" after the games and
+// prints 1 for every a who can beat b through a chain of wins, 0 otherwise
+void AnswerReachabilityInput(FastInput & input, const DirectedGraph & incidenceMatrix, 
+    BufferedWriter & writer)
+{
+    int queriesCount = 0;
+    input.Read(queriesCount);
+    vector<ReachabilityQuery> queries(queriesCount);
+    for (int query = 0; query < queriesCount; ++query)
+    {
+        input.Read(queries[query].from);
+        input.Read(queries[query].to);
+        --queries[query].from;
+        --queries[query].to;
+    }
+    StronglyConnectedComponentsReachabilityInfo stronglyConnectedComponentsReachabilityInfo;
+    ComputeStronglyConnectedComponentsReachability(incidenceMatrix, PEARCE, 1, 
+        stronglyConnectedComponentsReachabilityInfo);
+    const StronglyConnectedComponentsInfo & stronglyConnectedComponentsInfo = 
+        stronglyConnectedComponentsReachabilityInfo.GetStronglyConnectedComponentsInfo();
+    CondensationReachabilityIndex condensationReachabilityIndex;
+    condensationReachabilityIndex.Build(
+        BuildCondensation(incidenceMatrix, stronglyConnectedComponentsInfo), 
+        TRANSITIVE_CLOSURE_MAX_COMPONENTS);
+    vector<bool> answers;
+    AnswerReachabilityQueries(stronglyConnectedComponentsInfo, condensationReachabilityIndex, 
+        queries, answers);
+    for (int query = 0; query < queriesCount; ++query)
+    {
+        writer.WriteChar(answers[query] ? '1' : '0');
+        writer.WriteChar('\n');
+    }
+}
+
+double GetSecondsSince(const struct timespec & start)
+{
+    struct timespec finish;
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    return (finish.tv_sec - start.tv_sec) + (finish.tv_nsec - start.tv_nsec) * 1e-9;
+}
+
+bool IsReachableBySearch(const DirectedGraph & incidenceMatrix, int from, int to)
+{
+    vector<bool> visited(incidenceMatrix.GetVertexCount(), false);
+    vector<int> queue(1, from);
+    visited[from] = true;
+    for (size_t queued = 0; queued < queue.size(); ++queued)
+    {
+        if (to == queue[queued])
+        {
+            return true;
+        }
+        for (int edge = incidenceMatrix.GetFirstEdge(queue[queued]); 
+            edge < incidenceMatrix.GetLastEdge(queue[queued]); 
+            ++edge)
+        {
+            int target = incidenceMatrix.GetEdgeTarget(edge);
+            if (!visited[target])
+            {
+                visited[target] = true;
+                queue.push_back(target);
+            }
+        }
+    }
+    return false;
+}
+
+const int REACHABILITY_WALK_LENGTH = 64;
+const int VERIFIED_REACHABILITY_QUERIES = 100;
+
+// Builds the components, the condensation and its index, then answers
+// queriesCount queries in one batch. Every other query pairs uniform players,
+// the rest end a random walk along wins, so both answers occur. Prints the
+// build times and sizes as JSON and fails if one of the first queries
+// disagrees with a breadth-first search over the games.
+bool BenchmarkReachability(const DirectedGraph & incidenceMatrix, int queriesCount, 
+    int closureComponentsLimit)
+{
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    StronglyConnectedComponentsReachabilityInfo stronglyConnectedComponentsReachabilityInfo;
+    ComputeStronglyConnectedComponentsReachability(incidenceMatrix, PEARCE, 1, 
+        stronglyConnectedComponentsReachabilityInfo);
+    const StronglyConnectedComponentsInfo & stronglyConnectedComponentsInfo = 
+        stronglyConnectedComponentsReachabilityInfo.GetStronglyConnectedComponentsInfo();
+    double componentsSeconds = GetSecondsSince(start);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    DirectedGraph condensation = BuildCondensation(incidenceMatrix, 
+                                                   stronglyConnectedComponentsInfo);
+    double condensationSeconds = GetSecondsSince(start);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    CondensationReachabilityIndex condensationReachabilityIndex;
+    condensationReachabilityIndex.Build(condensation, closureComponentsLimit);
+    double indexSeconds = GetSecondsSince(start);
+
+    int peopleNumber = incidenceMatrix.GetVertexCount();
+    std::mt19937 random(1);
+    vector<ReachabilityQuery> queries(peopleNumber > 0 ? queriesCount : 0);
+    for (size_t query = 0; query < queries.size(); ++query)
+    {
+        queries[query].from = random() % peopleNumber;
+        queries[query].to = random() % peopleNumber;
+        if (1 == query % 2)
+        {
+            queries[query].to = queries[query].from;
+            for (int step = 0; step < REACHABILITY_WALK_LENGTH; ++step)
+            {
+                int degree = incidenceMatrix.GetLastEdge(queries[query].to) - 
+                    incidenceMatrix.GetFirstEdge(queries[query].to);
+                if (0 == degree)
+                {
+                    break;
+                }
+                queries[query].to = incidenceMatrix.GetEdgeTarget(
+                    incidenceMatrix.GetFirstEdge(queries[query].to) + random() % degree);
+            }
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    vector<bool> answers;
+    AnswerReachabilityQueries(stronglyConnectedComponentsInfo, condensationReachabilityIndex, 
+        queries, answers);
+    double queriesSeconds = GetSecondsSince(start);
+    int reachableCount = std::count(answers.begin(), answers.end(), true);
+    int verifiedCount = std::min<int>(queries.size(), VERIFIED_REACHABILITY_QUERIES);
+    bool agree = true;
+    for (int query = 0; query < verifiedCount; ++query)
+    {
+        if (answers[query] != 
+            IsReachableBySearch(incidenceMatrix, queries[query].from, queries[query].to))
+        {
+            agree = false;
+        }
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("{\"vertices\": %d, \"edges\": %d, \"components\": %d, "
+           "\"condensation_edges\": %d, \"index\": \"%s\", \"chains\": %d, \"labels\": %lld, "
+           "\"components_seconds\": %.6f, \"condensation_seconds\": %.6f, "
+           "\"index_seconds\": %.6f, \"index_bytes\": %lld, \"peak_rss_kb\": %ld, "
+           "\"queries\": %d, \"queries_seconds\": %.6f, \"queries_per_second\": %.0f, "
+           "\"reachable\": %d, \"verified\": %d}\n",
+           peopleNumber, incidenceMatrix.GetEdgeCount(), condensation.GetVertexCount(),
+           condensation.GetEdgeCount(), 
+           condensationReachabilityIndex.UsesTransitiveClosure() ? "closure" : "labels",
+           condensationReachabilityIndex.GetChainsCount(),
+           condensationReachabilityIndex.GetLabelsCount(),
+           componentsSeconds, condensationSeconds, indexSeconds, 
+           condensationReachabilityIndex.GetMemoryBytes(), usage.ru_maxrss,
+           static_cast<int>(queries.size()), queriesSeconds, 
+           queriesSeconds > 0 ? queries.size() / queriesSeconds : 0.0,
+           reachableCount, verifiedCount);
+    fflush(stdout);
+    if (!agree)
+    {
+        fprintf(stderr, "the reachability index disagrees with a search over the games\n");
+    }
+    return agree;
+}
+
+// Power-law games pick both players with a heavy bias towards small numbers,
+// so a few players take part in most games. Near-tournament games pair
+// players uniformly and the smaller number wins nine times out of ten, so
+// the graph is a ranking broken by upsets.
+bool GenerateGames(const char * kind, int peopleNumber, int gamesNumber, 
+    unsigned int seed, BufferedWriter & writer)
+{
+    bool powerLaw = 0 == strcmp("power-law", kind);
+    if ((!powerLaw && 0 != strcmp("tournament", kind)) || peopleNumber <= 0)
+    {
+        return false;
+    }
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    writer.WriteNumber(peopleNumber);
+    writer.WriteChar(' ');
+    writer.WriteNumber(gamesNumber);
+    writer.WriteChar('\n');
+    for (int gameCounter = 0; gameCounter < gamesNumber; ++gameCounter)
+    {
+        int first = 0, second = 0, gameResult = DRAW;
+        if (powerLaw)
+        {
+            first = std::min(peopleNumber - 1, 
+                             static_cast<int>(peopleNumber * pow(uniform(random), 3.0)));
+            second = std::min(peopleNumber - 1, 
+                              static_cast<int>(peopleNumber * pow(uniform(random), 3.0)));
+            double outcome = uniform(random);
+            gameResult = outcome < 0.45 ? FIRST_WIN : (outcome < 0.9 ? SECOND_WIN : DRAW);
+        }
+        else
+        {
+            first = std::min(peopleNumber - 1, static_cast<int>(peopleNumber * uniform(random)));
+            second = std::min(peopleNumber - 1, static_cast<int>(peopleNumber * uniform(random)));
+            bool upset = uniform(random) < 0.1;
+            gameResult = (first < second) != upset ? FIRST_WIN : SECOND_WIN;
+        }
+        writer.WriteNumber(first + 1);
+        writer.WriteChar(' ');
+        writer.WriteNumber(second + 1);
+        writer.WriteChar(' ');
+        writer.WriteNumber(gameResult);
+        writer.WriteChar('\n');
+    }
+    return true;
+}
+
+// Usage: 4-2 [--kosaraju | --threads count | --benchmark-scc [max threads]]
+//        4-2 --incremental | --benchmark-incremental
+//        4-2 --reachability | --benchmark-reachability [queries [closure limit]]
+//        4-2 --generate-games power-law|tournament people games [seed]
+// Components are found with Pearce's algorithm unless --kosaraju is given;
+// --threads finds them with count threads (0 means one per core).
+// --benchmark-scc runs every algorithm on the input, prints their time and
+// peak memory as JSON and fails if their answers differ. --incremental
+// prints the team size after every game; --benchmark-incremental measures
+// how fast games are taken in that way. With --reachability the games are
+// followed by the number of queries and the queries "a b", and 1 or 0 is
+// printed for each depending on whether a can beat b through a chain of wins.
+// --benchmark-reachability answers random queries that way and reports the
+// build times and the size of the index as JSON; the condensation keeps its
+// transitive closure while it has at most closure limit components.
+// --generate-games reads nothing and prints a synthetic input.
+int main(int argc, char * argv[])
+{
+    if (argc > 4 && 0 == strcmp("--generate-games", argv[1]))
+    {
+        BufferedWriter writer(stdout);
+        return GenerateGames(argv[2], atoi(argv[3]), atoi(argv[4]), 
+                             argc > 5 ? atoi(argv[5]) : 1, writer) ? 0 : 1;
+    }
+    FastInput input(stdin);
+    int peopleNumber = 0, gamesNumber = 0;
+    input.Read(peopleNumber);
+    input.Read(gamesNumber);
+    if (argc > 1 && 0 == strcmp("--incremental", argv[1]))
+    {
+        BufferedWriter writer(stdout);
+        FollowTeamSize(input, peopleNumber, gamesNumber, writer);
+        return 0;
+    }
+    if (argc > 1 && 0 == strcmp("--benchmark-incremental", argv[1]))
+    {
+        return BenchmarkIncrementalStronglyConnectedComponents(
+            ReadGames(input, gamesNumber), peopleNumber) ? 0 : 1;
+    }
+    DirectedGraph incidenceMatrix;
+    {
+        vector<Game> games = ReadGames(input, gamesNumber);
+        incidenceMatrix = BuildIncidenceMatrix(games, peopleNumber);
+    }
+    if (argc > 1 && 0 == strcmp("--reachability", argv[1]))
+    {
+        BufferedWriter writer(stdout);
+        AnswerReachabilityInput(input, incidenceMatrix, writer);
+        return 0;
+    }
+    if (argc > 1 && 0 == strcmp("--benchmark-reachability", argv[1]))
+    {
+        return BenchmarkReachability(incidenceMatrix, argc > 2 ? atoi(argv[2]) : 1000000, 
+            argc > 3 ? atoi(argv[3]) : TRANSITIVE_CLOSURE_MAX_COMPONENTS) ? 0 : 1;
+    }
+    if (argc > 1 && 0 == strcmp("--benchmark-scc", argv[1]))
+    {
+        int maxThreadsCount = argc > 2 ? atoi(argv[2]) : 
+            std::max(1u, std::thread::hardware_concurrency());
+        return BenchmarkStronglyConnectedComponents(incidenceMatrix, 
+            std::max(1, maxThreadsCount)) ? 0 : 1;
+    }
+    StronglyConnectedComponentsAlgorithm algorithm = PEARCE;
+    int threadsCount = 1;
+    if (argc > 1 && 0 == strcmp("--kosaraju", argv[1]))
+    {
+        algorithm = KOSARAJU;
+    }
+    if (argc > 2 && 0 == strcmp("--threads", argv[1]))
+    {
+        algorithm = PARALLEL;
+        threadsCount = atoi(argv[2]);
+    }
+    StronglyConnectedComponentsReachabilityInfo stronglyConnectedComponentsReachabilityInfo;
+    ComputeStronglyConnectedComponentsReachability(incidenceMatrix, algorithm, threadsCount,
+        stronglyConnectedComponentsReachabilityInfo);
+    BufferedWriter writer(stdout);
+    writer.WriteNumber(GetTeamSize(stronglyConnectedComponentsReachabilityInfo));
+    writer.WriteChar('\n');
     return 0;
 }